@@ -0,0 +1,157 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+
+#include "Options.h"
+#include "Dream3DDataReader.h"
+#include "ArrayImporter.h"
+
+/**
+ * @brief Counts the voxel faces between different materials by calling GiveMaterialIDByIndex for each voxel and its
+ * neighbours. Like FindSurfaces, only the positive directions are checked, and the negative directions on the
+ * boundary.
+ * @param Imp Importer
+ * @param dim Number of voxels in each dimension
+ * @return Number of faces
+ */
+size_t CountFacesByIndex(voxel2tet::Importer *Imp, const int dim[3])
+{
+    size_t Faces = 0;
+    for (int k = 0; k < dim[2]; k++) {
+        for (int j = 0; j < dim[1]; j++) {
+            for (int i = 0; i < dim[0]; i++) {
+                int ThisID = Imp->GiveMaterialIDByIndex(i, j, k);
+                int Neighbours[6] = {Imp->GiveMaterialIDByIndex(i + 1, j, k), Imp->GiveMaterialIDByIndex(i, j + 1, k),
+                                     Imp->GiveMaterialIDByIndex(i, j, k + 1),
+                                     (i == 0) ? Imp->GiveMaterialIDByIndex(i - 1, j, k) : ThisID,
+                                     (j == 0) ? Imp->GiveMaterialIDByIndex(i, j - 1, k) : ThisID,
+                                     (k == 0) ? Imp->GiveMaterialIDByIndex(i, j, k - 1) : ThisID};
+                for (int m = 0; m < 6; m++) {
+                    Faces += (Neighbours[m] != ThisID);
+                }
+            }
+        }
+    }
+    return Faces;
+}
+
+/**
+ * @brief Counts the voxel faces between different materials by reading the labels of the padded grid through the
+ * strides, as FindVoxelFaces does. The grid must be stored in the linear layout.
+ * @param Labels Label grid
+ * @return Number of faces
+ */
+template <typename T>
+size_t CountFacesByLabels(voxel2tet::LabelGridBase *Labels)
+{
+    const T *L = Labels->GiveLabels<T>();
+    const size_t *Strides = Labels->GiveStrides();
+    const int *dim = Labels->GiveDimensions();
+
+    size_t Faces = 0;
+    for (int k = 0; k < dim[2]; k++) {
+        for (int j = 0; j < dim[1]; j++) {
+            size_t RowIndex = Labels->GiveIndex(0, j, k);
+            for (int i = 0; i < dim[0]; i++) {
+                size_t index = RowIndex + i;
+                T ThisLabel = L[index];
+                T Neighbours[6] = {L[index + Strides[0]], L[index + Strides[1]], L[index + Strides[2]],
+                                   (i == 0) ? L[index - Strides[0]] : ThisLabel,
+                                   (j == 0) ? L[index - Strides[1]] : ThisLabel,
+                                   (k == 0) ? L[index - Strides[2]] : ThisLabel};
+                for (int m = 0; m < 6; m++) {
+                    Faces += (Neighbours[m] != ThisLabel);
+                }
+            }
+        }
+    }
+    return Faces;
+}
+
+/**
+ * @brief Gives the time in seconds elapsed since Start
+ */
+double GiveSeconds(std::chrono::steady_clock::time_point Start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+/**
+ * Compares the voxel throughput of scanning for faces through the padded label grid with scanning through
+ * Importer::GiveMaterialIDByIndex. The voxel data of a Dream3D file is tiled -scale times in each direction.
+ *
+ * Options:
+ *  -input File     Dream3D file (default ExampleInput/40x40x40.dream3d)
+ *  -scale S        Number of copies of the data in each direction (default 4)
+ *  -DataContainer  Name of the data container in the Dream3D file (default VoxelDataContainer)
+ *  -MaterialId     Name of the material ID array in the Dream3D file (default GrainIds)
+ */
+int main(int argc, char *argv[])
+{
+    std::map<std::string, std::string> DefaultOptions;
+    DefaultOptions["input"] = "ExampleInput/40x40x40.dream3d";
+    DefaultOptions["scale"] = "4";
+    DefaultOptions["DataContainer"] = "VoxelDataContainer";
+    DefaultOptions["MaterialId"] = "GrainIds";
+    voxel2tet::Options *Options = new voxel2tet::Options(argc, argv, DefaultOptions, {});
+    int Scale = Options->GiveIntegerValue("scale");
+
+    voxel2tet::Dream3DDataReader Reader(Options->GiveStringValue("DataContainer"),
+                                        Options->GiveStringValue("MaterialId"));
+    Reader.LoadFile(Options->GiveStringValue("input"));
+    int InputDimensions[3];
+    Reader.GiveDimensions(InputDimensions);
+
+    std::array<int, 3> Dimensions;
+    for (int d = 0; d < 3; d++) {
+        Dimensions[d] = InputDimensions[d] * Scale;
+    }
+    size_t NumberOfVoxels = (size_t) Dimensions[0] * Dimensions[1] * Dimensions[2];
+    std::vector<int> Data(NumberOfVoxels);
+    for (int k = 0; k < Dimensions[2]; k++) {
+        for (int j = 0; j < Dimensions[1]; j++) {
+            int *Row = Data.data() + ((size_t) k * Dimensions[1] + j) * Dimensions[0];
+            for (int i = 0; i < Dimensions[0]; i++) {
+                Row[i] = Reader.GiveMaterialIDByIndex(i % InputDimensions[0], j % InputDimensions[1],
+                                                      k % InputDimensions[2]);
+            }
+        }
+    }
+
+    voxel2tet::ArrayImporter<int> Imp(Data.data(), Dimensions, {{0, 0, 0}}, {{1, 1, 1}});
+
+    auto Start = std::chrono::steady_clock::now();
+    size_t IndexFaces = CountFacesByIndex(&Imp, Dimensions.data());
+    double IndexSeconds = GiveSeconds(Start);
+
+    Start = std::chrono::steady_clock::now();
+    voxel2tet::LabelGridBase *Labels = Imp.GiveLabelGrid();
+    double BuildSeconds = GiveSeconds(Start);
+
+    Start = std::chrono::steady_clock::now();
+    size_t LabelFaces;
+    switch (Labels->GiveBytesPerLabel()) {
+    case 1:
+        LabelFaces = CountFacesByLabels<uint8_t>(Labels);
+        break;
+    case 2:
+        LabelFaces = CountFacesByLabels<uint16_t>(Labels);
+        break;
+    default:
+        LabelFaces = CountFacesByLabels<uint32_t>(Labels);
+        break;
+    }
+    double LabelSeconds = GiveSeconds(Start);
+
+    printf("Voxels: %d*%d*%d = %zu, faces: %zu\n", Dimensions[0], Dimensions[1], Dimensions[2], NumberOfVoxels,
+           IndexFaces);
+    printf("GiveMaterialIDByIndex: %.3f s, %.1f Mvoxels/s\n", IndexSeconds, NumberOfVoxels / IndexSeconds * 1e-6);
+    printf("Padded label grid:     %.3f s, %.1f Mvoxels/s (%d bytes per label)\n", LabelSeconds,
+           NumberOfVoxels / LabelSeconds * 1e-6, Labels->GiveBytesPerLabel());
+    printf("Building the label grid: %.3f s, %.1f Mvoxels/s\n", BuildSeconds, NumberOfVoxels / BuildSeconds * 1e-6);
+    if (LabelFaces != IndexFaces) {
+        std::cout << "Number of faces differ: " << LabelFaces << " from the label grid\n";
+        exit(-1);
+    }
+}
@@ -1,8 +1,6 @@
 #include <iostream>
 
-#define ARMA_USE_CXX11
-
-#include <armadillo>
+#include <cmath>
 
 #include "Options.h"
 #include "Voxel2Tet.h"
@@ -11,30 +9,56 @@ std::vector<std::array<double, 3>> Coordinates0;
 std::vector<std::array<double, 3>> Coordinates1;
 
 /**
- * @brief Callback function being called from Voxel2Tet. Describes the geometry implicitly by returning
- * the ID of the material in the given coordinate.
- * @param x X coordinate
- * @param y Y coordinate
- * @param z Z coordinate
- * @return Material ID
+ * @brief Batch callback function being called from Voxel2Tet. Describes the geometry implicitly by giving the ID of the
+ * material in each voxel of a slab.
+ * @param Origin Centre of first voxel in slab
+ * @param Spacing Distance between voxel centres
+ * @param Extent Number of voxels in slab
+ * @param MaterialIDs Output. Material IDs, x fastest
  */
-int GiveMaterialIDByCoordinateMultiSphere(double x, double y, double z)
+void GiveMaterialIDsBySlabFibers(std::array<double, 3> Origin, std::array<double, 3> Spacing,
+                                 std::array<int, 3> Extent, int *MaterialIDs)
 {
     double r = .1;
 
-	arma::vec x0 = {x, y, z};
-
+    // Unit direction of each fiber
+    std::vector<std::array<double, 3>> Directions;
     for (size_t i = 0; i < Coordinates0.size(); i++) {
-        arma::vec x1 = {Coordinates0[i][0], Coordinates0[i][1], Coordinates0[i][2]};
-        arma::vec x2 = {Coordinates1[i][0], Coordinates1[i][1], Coordinates1[i][2]};
-        double nominator = arma::norm(arma::cross(x2 - x1, x1 - x0));
-        double denominator = arma::norm(x2 - x1);
-        double d = nominator / denominator;
-        if (d < r) return 1;
+        std::array<double, 3> u;
+        for (int j = 0; j < 3; j++) {
+            u[j] = Coordinates1[i][j] - Coordinates0[i][j];
+        }
+        double l = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        for (int j = 0; j < 3; j++) {
+            u[j] /= l;
+        }
+        Directions.push_back(u);
     }
 
-    return 2;
-
+    for (int zi = 0; zi < Extent[2]; zi++) {
+        double z = Origin[2] + zi * Spacing[2];
+        for (int yi = 0; yi < Extent[1]; yi++) {
+            double y = Origin[1] + yi * Spacing[1];
+            int *Row = MaterialIDs + ((size_t) zi * Extent[1] + yi) * Extent[0];
+            for (int xi = 0; xi < Extent[0]; xi++) {
+                Row[xi] = 2;
+            }
+
+            // The distance to the fiber is the norm of u x (x1 - x0) where u is the unit direction of the fiber
+            for (size_t i = 0; i < Coordinates0.size(); i++) {
+                const std::array<double, 3> &u = Directions[i];
+                double wy = Coordinates0[i][1] - y;
+                double wz = Coordinates0[i][2] - z;
+                for (int xi = 0; xi < Extent[0]; xi++) {
+                    double wx = Coordinates0[i][0] - (Origin[0] + xi * Spacing[0]);
+                    double cx = u[1] * wz - u[2] * wy;
+                    double cy = u[2] * wx - u[0] * wz;
+                    double cz = u[0] * wy - u[1] * wx;
+                    Row[xi] = (cx * cx + cy * cy + cz * cz < r * r) ? 1 : Row[xi];
+                }
+            }
+        }
+    }
 }
 
 int main(int argc, char *argv[])
@@ -72,7 +96,7 @@ int main(int argc, char *argv[])
         Coordinates1.push_back(c1);
     }
 
-    v2t.LoadCallback(&GiveMaterialIDByCoordinateMultiSphere, {{0, 0, 0}}, {{spacing, spacing, spacing}}, dimensions);
+    v2t.LoadCallback(&GiveMaterialIDsBySlabFibers, {{0, 0, 0}}, {{spacing, spacing, spacing}}, dimensions);
     v2t.Process();
     v2t.Tetrahedralize();
 
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Options.h"
+#include "Voxel2Tet.h"
+
+/**
+ * Number of voxels in each direction. The grid holds more than 2^31 voxels, i.e. more than an int can index.
+ */
+const std::array<int, 3> Dimensions = {{2048, 1024, 1025}};
+
+/**
+ * Index of the first voxel and number of voxels of a box of material 1 in void (material 0). The box is placed in the
+ * last slices of the grid, where the linear voxel indices exceed 2^31.
+ */
+const std::array<int, 3> BoxFirst = {{2030, 1000, 1005}};
+const std::array<int, 3> BoxSize = {{10, 12, 14}};
+
+/**
+ * @brief Batch callback function being called from Voxel2Tet. Describes a single small box in a large grid, i.e. almost
+ * all voxels hold the same material.
+ * @param Origin Centre of first voxel in slab
+ * @param Spacing Distance between voxel centres
+ * @param Extent Number of voxels in slab
+ * @param MaterialIDs Output. Material IDs, x fastest
+ */
+void GiveMaterialIDsBySlabSparse(std::array<double, 3> Origin, std::array<double, 3> Spacing,
+                                 std::array<int, 3> Extent, int *MaterialIDs)
+{
+    std::fill(MaterialIDs, MaterialIDs + (size_t) Extent[0] * Extent[1] * Extent[2], 0);
+
+    // Range of the box in voxels of the slab
+    std::array<int, 3> First, End;
+    for (int i = 0; i < 3; i++) {
+        int SlabFirst = (int) (Origin[i] / Spacing[i]);
+        First[i] = std::max(BoxFirst[i] - SlabFirst, 0);
+        End[i] = std::min(BoxFirst[i] + BoxSize[i] - SlabFirst, Extent[i]);
+    }
+
+    for (int zi = First[2]; zi < End[2]; zi++) {
+        for (int yi = First[1]; yi < End[1]; yi++) {
+            int *Row = MaterialIDs + ((size_t) zi * Extent[1] + yi) * Extent[0];
+            for (int xi = First[0]; xi < End[0]; xi++) {
+                Row[xi] = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stops the program with an error message unless Condition holds
+ */
+void Check(bool Condition, std::string Message)
+{
+    if (!Condition) {
+        std::cout << "Check failed: " << Message << "\n";
+        exit(-1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::map<std::string, std::string> DefaultOptions;
+    voxel2tet::Options *Options = new voxel2tet::Options(argc, argv, DefaultOptions, {});
+    Options->SetKey("nocoarsening", "1");
+    // Otherwise, the boundary of the grid would be meshed as well
+    Options->SetKey("treatzeroasvoid", "1");
+
+    voxel2tet::Voxel2TetClass v2t(Options);
+
+    size_t NumberOfVoxels = (size_t) Dimensions[0] * Dimensions[1] * Dimensions[2];
+    Check(NumberOfVoxels > ((size_t) 1 << 31), "grid does not exceed 2^31 voxels");
+
+    v2t.LoadCallback(&GiveMaterialIDsBySlabSparse, {{0, 0, 0}}, {{1, 1, 1}}, Dimensions);
+    v2t.Process();
+
+    // The surface of the box is the only interface. Each voxel face on it is split into two triangles and, without
+    // coarsening, the numbers of entities are those of the voxel faces.
+    size_t a = BoxSize[0], b = BoxSize[1], c = BoxSize[2];
+    size_t ExpectedVertices = (a + 1) * (b + 1) * (c + 1) - (a - 1) * (b - 1) * (c - 1);
+    size_t ExpectedTriangles = 4 * (a * b + b * c + c * a);
+    size_t ExpectedEdges = 6 * (a * b + b * c + c * a);
+
+    voxel2tet::MeshManipulations *Mesh = v2t.Mesh;
+    std::cout << "Voxels: " << NumberOfVoxels << ", vertices: " << Mesh->Vertices.size() << ", triangles: "
+              << Mesh->Triangles.size() << ", edges: " << Mesh->Edges.size() << "\n";
+    Check(Mesh->Vertices.size() == ExpectedVertices, "wrong number of vertices");
+    Check(Mesh->Triangles.size() == ExpectedTriangles, "wrong number of triangles");
+    Check(Mesh->Edges.size() == ExpectedEdges, "wrong number of edges");
+
+    // Vertex IDs are the positions in the list of vertices. The vertices stay within one voxel of the box while smoothed.
+    for (size_t i = 0; i < Mesh->Vertices.size(); i++) {
+        voxel2tet::VertexType *v = Mesh->Vertices[i];
+        Check(v->ID == (voxel2tet::IDType) i, "vertex ID differs from its position");
+        for (int j = 0; j < 3; j++) {
+            Check((v->get_c(j) > BoxFirst[j] - 1) && (v->get_c(j) < BoxFirst[j] + BoxSize[j] + 1),
+                  "vertex outside the box");
+        }
+    }
+
+    // Edge and triangle IDs are unique and the triangles separate the box from the void
+    std::vector<voxel2tet::IDType> EdgeIDs, TriangleIDs;
+    for (voxel2tet::EdgeType *e : Mesh->Edges) {
+        EdgeIDs.push_back(e->ID);
+    }
+    for (voxel2tet::TriangleType *t : Mesh->Triangles) {
+        TriangleIDs.push_back(t->ID);
+        Check(((t->PosNormalMatID == 1) && (t->NegNormalMatID == 0)) ||
+              ((t->PosNormalMatID == 0) && (t->NegNormalMatID == 1)), "triangle between wrong materials");
+    }
+    std::sort(EdgeIDs.begin(), EdgeIDs.end());
+    std::sort(TriangleIDs.begin(), TriangleIDs.end());
+    Check(std::adjacent_find(EdgeIDs.begin(), EdgeIDs.end()) == EdgeIDs.end(), "duplicate edge IDs");
+    Check(std::adjacent_find(TriangleIDs.begin(), TriangleIDs.end()) == TriangleIDs.end(), "duplicate triangle IDs");
+
+    std::cout << "All checks passed\n";
+}
@@ -6,25 +6,40 @@
 std::vector<std::array<double, 3>> Coordinates;
 
 /**
- * @brief Callback function being called from Voxel2Tet. Describes the geometry implicitly by returning
- * the ID of the material in the given coordinate.
- * @param x X coordinate
- * @param y Y coordinate
- * @param z Z coordinate
- * @return Material ID
+ * @brief Batch callback function being called from Voxel2Tet. Describes the geometry implicitly by giving the ID of the
+ * material in each voxel of a slab.
+ * @param Origin Centre of first voxel in slab
+ * @param Spacing Distance between voxel centres
+ * @param Extent Number of voxels in slab
+ * @param MaterialIDs Output. Material IDs, x fastest
  */
-int GiveMaterialIDByCoordinateMultiSphere(double x, double y, double z)
+void GiveMaterialIDsBySlabMultiSphere(std::array<double, 3> Origin, std::array<double, 3> Spacing,
+                                      std::array<int, 3> Extent, int *MaterialIDs)
 {
     double r = .3;
 
-    for (std::array<double, 3> C: Coordinates) {
-        if (sqrt(pow(x - C[0], 2) + pow(y - C[1], 2) + pow(z - C[2], 2)) < r) {
-            return 1;
+    for (int zi = 0; zi < Extent[2]; zi++) {
+        double z = Origin[2] + zi * Spacing[2];
+        for (int yi = 0; yi < Extent[1]; yi++) {
+            double y = Origin[1] + yi * Spacing[1];
+            int *Row = MaterialIDs + ((size_t) zi * Extent[1] + yi) * Extent[0];
+            for (int xi = 0; xi < Extent[0]; xi++) {
+                Row[xi] = 2;
+            }
+
+            // Mark voxels inside each sphere. Only the squared distance in x varies along the row.
+            for (std::array<double, 3> C: Coordinates) {
+                double ryz2 = r * r - (y - C[1]) * (y - C[1]) - (z - C[2]) * (z - C[2]);
+                if (ryz2 <= 0) {
+                    continue;
+                }
+                for (int xi = 0; xi < Extent[0]; xi++) {
+                    double dx = Origin[0] + xi * Spacing[0] - C[0];
+                    Row[xi] = (dx * dx < ryz2) ? 1 : Row[xi];
+                }
+            }
         }
     }
-
-    return 2;
-
 }
 
 int main(int argc, char *argv[])
@@ -54,7 +69,7 @@ int main(int argc, char *argv[])
         Coordinates.push_back(cp);
     }
 
-    v2t.LoadCallback(&GiveMaterialIDByCoordinateMultiSphere, {{0, 0, 0}}, {{spacing, spacing, spacing}}, dimensions);
+    v2t.LoadCallback(&GiveMaterialIDsBySlabMultiSphere, {{0, 0, 0}}, {{spacing, spacing, spacing}}, dimensions);
     v2t.Process();
     v2t.Tetrahedralize();
 
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+
+#include "Options.h"
+#include "Parallel.h"
+#include "VTKStructuredReader.h"
+
+/**
+ * @brief Gives the label of a voxel. The grid is split into grains of 16^3 voxels with labels of one to four digits, so
+ * that the file holds a mix of value widths like a segmented microstructure.
+ * @param xi Voxel index in x direction
+ * @param yi Voxel index in y direction
+ * @param zi Voxel index in z direction
+ * @return Label of the voxel
+ */
+int GiveLabel(int xi, int yi, int zi)
+{
+    unsigned int h = (unsigned int) (xi / 16) * 73856093u ^ (unsigned int) (yi / 16) * 19349663u ^
+                     (unsigned int) (zi / 16) * 83492791u;
+    return (int) (h % 2000);
+}
+
+/**
+ * @brief Writes a legacy ASCII VTK file with cell data given by GiveLabel, one row of voxels per line
+ * @param FileName Name of file
+ * @param N Number of voxels in each direction
+ */
+void WriteASCIIFile(std::string FileName, int N)
+{
+    std::ofstream Output(FileName);
+    Output << "# vtk DataFile Version 2.0\n";
+    Output << "VTK ASCII benchmark\n";
+    Output << "ASCII\n";
+    Output << "DATASET STRUCTURED_POINTS\n";
+    Output << "DIMENSIONS " << N + 1 << " " << N + 1 << " " << N + 1 << "\n";
+    Output << "ORIGIN 0 0 0\n";
+    Output << "SPACING 1 1 1\n";
+    Output << "CELL_DATA " << (size_t) N * N * N << "\n";
+    Output << "SCALARS GrainIds int 1\n";
+    Output << "LOOKUP_TABLE default\n";
+
+    std::string Line;
+    char Value[16];
+    for (int zi = 0; zi < N; zi++) {
+        for (int yi = 0; yi < N; yi++) {
+            Line.clear();
+            for (int xi = 0; xi < N; xi++) {
+                int Length = snprintf(Value, sizeof(Value), "%d ", GiveLabel(xi, yi, zi));
+                Line.append(Value, Length);
+            }
+            Line.back() = '\n';
+            Output << Line;
+        }
+    }
+}
+
+/**
+ * Generates a large ASCII VTK file and reports the throughput of VTKStructuredReader when parsing it. The time covers
+ * VTKStructuredReader::LoadFile, which is dominated by parsing the data section (ParseASCIIData).
+ *
+ * Options:
+ *  -size N         Number of voxels in each direction (default 512)
+ *  -output File    Name of the generated file (default VTKASCIIBenchmark.vtk)
+ *  -threads T      Number of parsing threads (default 0, i.e. the number of hardware threads)
+ *  -keepfile       Do not delete the generated file
+ */
+int main(int argc, char *argv[])
+{
+    std::map<std::string, std::string> DefaultOptions;
+    DefaultOptions["size"] = "512";
+    DefaultOptions["output"] = "VTKASCIIBenchmark.vtk";
+    DefaultOptions["threads"] = "0";
+    voxel2tet::Options *Options = new voxel2tet::Options(argc, argv, DefaultOptions, {});
+
+    int N = Options->GiveIntegerValue("size");
+    std::string FileName = Options->GiveStringValue("output");
+    voxel2tet::SetNumberOfThreads(Options->GiveIntegerValue("threads"));
+
+    std::cout << "Writing " << N << "^3 voxels to " << FileName << "\n";
+    WriteASCIIFile(FileName, N);
+
+    std::ifstream File(FileName, std::ios::binary | std::ios::ate);
+    double FileSize = (double) File.tellg() / (1024.0 * 1024.0);
+    File.close();
+
+    voxel2tet::VTKStructuredReader Reader;
+    auto Start = std::chrono::steady_clock::now();
+    Reader.LoadFile(FileName);
+    auto Stop = std::chrono::steady_clock::now();
+    double Seconds = std::chrono::duration<double>(Stop - Start).count();
+
+    // Compare the parsed labels with the generated ones
+    int dimensions[3];
+    Reader.GiveDimensions(dimensions);
+    bool Correct = (dimensions[0] == N) && (dimensions[1] == N) && (dimensions[2] == N);
+    for (int zi = 0; Correct && (zi < N); zi++) {
+        for (int yi = 0; Correct && (yi < N); yi++) {
+            for (int xi = 0; xi < N; xi++) {
+                if (Reader.GiveMaterialIDByIndex(xi, yi, zi) != GiveLabel(xi, yi, zi)) {
+                    Correct = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!Options->GiveBooleanValue("keepfile")) {
+        std::remove(FileName.c_str());
+    }
+
+    printf("File size: %.1f MB, threads: %u, parse time: %.2f s, throughput: %.1f MB/s\n", FileSize,
+           voxel2tet::GiveNumberOfThreads(), Seconds, FileSize / Seconds);
+    if (!Correct) {
+        std::cout << "Parsed labels differ from the generated ones\n";
+        exit(-1);
+    }
+    std::cout << "Parsed labels match the generated ones\n";
+}
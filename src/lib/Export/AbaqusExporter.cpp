@@ -60,7 +60,7 @@ void AbaqusExporter::WriteVolumeData(std::string Filename)
     // Write tets
     AbaqusFile << "**\n** SOLID ELEMENTS\n**\n";
 
-    int LastElementID = 0;
+    IDType LastElementID = 0;
 
     for (auto a: MapSelfMaterials) {
         AbaqusFile << "*ELEMENT, TYPE=C3D4, ELSET=SOLID_" << a.first << "\n";
@@ -80,7 +80,7 @@ void AbaqusExporter::WriteVolumeData(std::string Filename)
     AbaqusFile << "*ELEMENT, TYPE=CPE3\n";
 
     for (TriangleType *t: *this->Triangles) {
-        int TriangleID = t->ID + LastElementID + 1;
+        IDType TriangleID = t->ID + LastElementID + 1;
         AbaqusFile << TriangleID << ",\t" << t->Vertices[0]->tag + 1 << ",\t" << t->Vertices[1]->tag + 1 << ",\t"
                    << t->Vertices[2]->tag + 1 << "\n";
     }
@@ -237,7 +237,7 @@ void AbaqusExporter::WriteVolumeData(std::string Filename)
                 k = 0;
 
                 for (size_t elcount = 0; elcount < this->TriangleSets[setid]->first.size(); elcount++) {
-                    int TriangleID = this->TriangleSets[setid]->first.at(elcount)->ID + 1 + LastElementID;
+                    IDType TriangleID = this->TriangleSets[setid]->first.at(elcount)->ID + 1 + LastElementID;
                     AbaqusFile << "\t" << TriangleID;
                     if (elcount != this->TriangleSets[setid]->first.size() - 1) AbaqusFile << ",";
                     if (k == 10) {
@@ -260,7 +260,7 @@ void AbaqusExporter::WriteVolumeData(std::string Filename)
             k = 0;
 
             for (size_t elcount = 0; elcount < this->GrainSets[setid]->first.size(); elcount++) {
-                int TetID = this->GrainSets[setid]->first.at(elcount)->ID + 1;
+                IDType TetID = this->GrainSets[setid]->first.at(elcount)->ID + 1;
                 AbaqusFile << "\t" << TetID;
                 if (elcount != this->GrainSets[setid]->first.size() - 1) AbaqusFile << ",";
                 if (k == 10) {
@@ -32,7 +32,7 @@ void TetGenExporter::WriteSurfaceData(std::string Filename)
 
     for (auto t : *this->Triangles) {
         TetGenFile << 1 << "\n" << 3;
-        std::array<int, 3> VertexIDs;
+        std::array<IDType, 3> VertexIDs;
         for (int i = 0; i < 3; i++) {
             VertexIDs[i] = t->Vertices[i]->ID;
             TetGenFile << "\t" << VertexIDs[i];
@@ -12,9 +12,9 @@ vtkSmartPointer<vtkPoints> VTKExporter::SetupVertices()
 {
     vtkSmartPointer<vtkPoints> Points = vtkPoints::New();
 
-    for (unsigned int i = 0; i < this->Vertices->size(); i++) {
+    for (size_t i = 0; i < this->Vertices->size(); i++) {
         VertexType *v = this->Vertices->at(i);
-        this->VertexMap[v] = i;
+        this->VertexMap[v] = (vtkIdType) i;
         Points->InsertNextPoint(v->get_c(0), v->get_c(1), v->get_c(2));
     }
     return Points;
@@ -28,7 +28,7 @@ vtkSmartPointer<vtkCellArray> VTKExporter::SetupTriangles()
         vtkSmartPointer<vtkTriangle> triangle = vtkSmartPointer<vtkTriangle>::New();
         for (int j = 0; j < 3; j++) {
             VertexType *v = t->Vertices[j];
-            int VertexId = this->VertexMap[v];
+            vtkIdType VertexId = this->VertexMap[v];
             triangle->GetPointIds()->SetId(j, VertexId);
         }
         Cells->InsertNextCell(triangle);
@@ -64,6 +64,18 @@ vtkSmartPointer<vtkIntArray> VTKExporter::SetupTriangleField(std::string Name, i
     return Triangles;
 }
 
+vtkSmartPointer<vtkIdTypeArray> VTKExporter::SetupTriangleField(std::string Name, IDType TriangleType::*FieldPtr)
+{
+    vtkSmartPointer<vtkIdTypeArray> Triangles = vtkIdTypeArray::New();
+    Triangles->SetNumberOfComponents(1);
+    Triangles->SetName(Name.c_str());
+    for (size_t i = 0; i < this->Triangles->size(); i++) {
+        TriangleType *v = this->Triangles->at(i);
+        Triangles->InsertNextValue((vtkIdType) (v->*FieldPtr));
+    }
+    return Triangles;
+}
+
 vtkSmartPointer<vtkIntArray> VTKExporter::SetupTetField(std::string Name, int TetType::*FieldPtr)
 {
     vtkSmartPointer<vtkIntArray> Triangles = vtkIntArray::New();
@@ -77,6 +89,18 @@ vtkSmartPointer<vtkIntArray> VTKExporter::SetupTetField(std::string Name, int Te
     return Triangles;
 }
 
+vtkSmartPointer<vtkIdTypeArray> VTKExporter::SetupTetField(std::string Name, IDType TetType::*FieldPtr)
+{
+    vtkSmartPointer<vtkIdTypeArray> Tets = vtkIdTypeArray::New();
+    Tets->SetNumberOfComponents(1);
+    Tets->SetName(Name.c_str());
+    for (size_t i = 0; i < this->Tets->size(); i++) {
+        TetType *t = this->Tets->at(i);
+        Tets->InsertNextValue((vtkIdType) (t->*FieldPtr));
+    }
+    return Tets;
+}
+
 vtkSmartPointer<vtkIntArray> VTKExporter::SetupVertexField(std::string Name, int VertexType::*FieldPtr)
 {
     vtkSmartPointer<vtkIntArray> VertexIDs = vtkIntArray::New();
@@ -90,6 +114,18 @@ vtkSmartPointer<vtkIntArray> VTKExporter::SetupVertexField(std::string Name, int
     return VertexIDs;
 }
 
+vtkSmartPointer<vtkIdTypeArray> VTKExporter::SetupVertexField(std::string Name, IDType VertexType::*FieldPtr)
+{
+    vtkSmartPointer<vtkIdTypeArray> VertexIDs = vtkIdTypeArray::New();
+    VertexIDs->SetNumberOfComponents(1);
+    VertexIDs->SetName(Name.c_str());
+    for (size_t i = 0; i < this->Vertices->size(); i++) {
+        VertexType *v = this->Vertices->at(i);
+        VertexIDs->InsertNextValue((vtkIdType) (v->*FieldPtr));
+    }
+    return VertexIDs;
+}
+
 vtkSmartPointer<vtkFloatArray> VTKExporter::SetupVertexField(std::string Name, double ( VertexType::*FieldPtr ))
 {
     vtkSmartPointer<vtkFloatArray> VertexIDs = vtkFloatArray::New();
@@ -111,7 +147,7 @@ void VTKExporter::WriteSurfaceData(std::string Filename)
     PolyData->SetPoints(Points);
 
     // ID
-    vtkSmartPointer<vtkIntArray> VertexID = SetupVertexField("Vertex ID", &VertexType::ID);
+    vtkSmartPointer<vtkIdTypeArray> VertexID = SetupVertexField("Vertex ID", &VertexType::ID);
     PolyData->GetPointData()->AddArray(VertexID);
 
     // tag
@@ -130,7 +166,7 @@ void VTKExporter::WriteSurfaceData(std::string Filename)
     PolyData->GetCellData()->AddArray(InterfaceID);
 
     // Triangle ID
-    vtkSmartPointer<vtkIntArray> TriangleID = SetupTriangleField("Triangle ID", &TriangleType::ID);
+    vtkSmartPointer<vtkIdTypeArray> TriangleID = SetupTriangleField("Triangle ID", &TriangleType::ID);
     PolyData->GetCellData()->AddArray(TriangleID);
 
     // Positive normal phase
@@ -163,7 +199,7 @@ void VTKExporter::WriteVolumeData(std::string Filename)
 
     UnstructuredGrid->SetCells(VTK_TETRA, TetArrays);
 
-    vtkSmartPointer<vtkIntArray> TetID = SetupTetField("Tet ID", &TetType::ID);
+    vtkSmartPointer<vtkIdTypeArray> TetID = SetupTetField("Tet ID", &TetType::ID);
     UnstructuredGrid->GetCellData()->AddArray(TetID);
 
     vtkSmartPointer<vtkIntArray> MatID = SetupTetField("Mat ID", &TetType::MaterialID);
@@ -19,6 +19,7 @@
 #include <vtkXMLUnstructuredGridWriter.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 
 namespace voxel2tet
 {
@@ -30,7 +31,7 @@ namespace voxel2tet
 class VTKExporter : public Exporter
 {
 private:
-    std::map<VertexType *, int> VertexMap;
+    std::map<VertexType *, vtkIdType> VertexMap;
 
     vtkSmartPointer<vtkPoints> SetupVertices();
 
@@ -40,12 +41,18 @@ private:
 
     vtkSmartPointer<vtkIntArray> SetupVertexField(std::string Name, int VertexType::*FieldPtr );
 
+    vtkSmartPointer<vtkIdTypeArray> SetupVertexField(std::string Name, IDType VertexType::*FieldPtr);
+
     vtkSmartPointer<vtkFloatArray> SetupVertexField(std::string Name, double ( VertexType::*FieldPtr ));
 
     vtkSmartPointer<vtkIntArray> SetupTriangleField(std::string Name, int TriangleType::*FieldPtr);
 
+    vtkSmartPointer<vtkIdTypeArray> SetupTriangleField(std::string Name, IDType TriangleType::*FieldPtr);
+
     vtkSmartPointer<vtkIntArray> SetupTetField(std::string Name, int TetType::*FieldPtr);
 
+    vtkSmartPointer<vtkIdTypeArray> SetupTetField(std::string Name, IDType TetType::*FieldPtr);
+
 public:
     /**
      * @copydoc Exporter::Exporter
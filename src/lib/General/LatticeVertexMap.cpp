@@ -0,0 +1,105 @@
+#include <algorithm>
+
+#include "LatticeVertexMap.h"
+
+namespace voxel2tet
+{
+
+LatticeVertexMap::LatticeVertexMap()
+{
+    for (int i = 0; i < 3; i++) {
+        this->dimensions_lattice[i] = 0;
+    }
+    this->NumberOfEntries = 0;
+    this->TableBits = 0;
+}
+
+void LatticeVertexMap::Initialize(const int Dimensions[3], size_t ExpectedNumberOfVertices)
+{
+    this->Clear();
+    for (int i = 0; i < 3; i++) {
+        this->dimensions_lattice[i] = Dimensions[i] + 1;
+    }
+
+    int Bits = 4;
+    while (((size_t) 1 << Bits) < 2 * ExpectedNumberOfVertices) {
+        Bits++;
+    }
+    this->Rehash(Bits);
+}
+
+void LatticeVertexMap::Rehash(int TableBits)
+{
+    std::vector<EntryType> OldTable;
+    OldTable.swap(this->Table);
+
+    this->TableBits = TableBits;
+    this->Table.assign((size_t) 1 << TableBits, {EmptyKey, -1});
+
+    size_t Mask = this->Table.size() - 1;
+    for (EntryType &e : OldTable) {
+        if (e.Key != EmptyKey) {
+            size_t Slot = this->GiveSlot(e.Key);
+            while (this->Table[Slot].Key != EmptyKey) {
+                Slot = (Slot + 1) & Mask;
+            }
+            this->Table[Slot] = e;
+        }
+    }
+}
+
+std::pair<IDType, bool> LatticeVertexMap::Insert(uint64_t Key, IDType ID)
+{
+    if (this->Table.empty() || (2 * (this->NumberOfEntries + 1) > this->Table.size())) {
+        this->Rehash(std::max(this->TableBits + 1, 4));
+    }
+
+    size_t Mask = this->Table.size() - 1;
+    size_t Slot = this->GiveSlot(Key);
+    while (this->Table[Slot].Key != EmptyKey) {
+        if (this->Table[Slot].Key == Key) {
+            return std::make_pair(this->Table[Slot].ID, false);
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+
+    this->Table[Slot].Key = Key;
+    this->Table[Slot].ID = ID;
+    this->NumberOfEntries++;
+    return std::make_pair(ID, true);
+}
+
+IDType LatticeVertexMap::Find(uint64_t Key) const
+{
+    if (this->Table.empty()) {
+        return -1;
+    }
+
+    size_t Mask = this->Table.size() - 1;
+    size_t Slot = this->GiveSlot(Key);
+    while (this->Table[Slot].Key != EmptyKey) {
+        if (this->Table[Slot].Key == Key) {
+            return this->Table[Slot].ID;
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+    return -1;
+}
+
+IDType LatticeVertexMap::Find(int i, int j, int k) const
+{
+    if ((i < 0) || (j < 0) || (k < 0) || (i >= this->dimensions_lattice[0]) || (j >= this->dimensions_lattice[1]) ||
+        (k >= this->dimensions_lattice[2])) {
+        return -1;
+    }
+    return this->Find(this->GiveKey(i, j, k));
+}
+
+void LatticeVertexMap::Clear()
+{
+    std::vector<EntryType>().swap(this->Table);
+    this->NumberOfEntries = 0;
+    this->TableBits = 0;
+}
+
+}
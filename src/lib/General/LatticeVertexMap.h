@@ -0,0 +1,123 @@
+#ifndef LATTICEVERTEXMAP_H
+#define LATTICEVERTEXMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "MeshComponents.h"
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Maps points in the lattice of voxel corners to vertex IDs. Each point is identified by its lattice indices
+ * (i, j, k), packed into a single integer key, which makes lookups exact and independent of any tolerance.
+ *
+ * The map is a flat hash table with open addressing and linear probing, which is grown as needed to stay at most half
+ * full.
+ */
+class LatticeVertexMap
+{
+private:
+    /**
+     * @brief Entry in hash table
+     */
+    typedef struct
+    {
+        uint64_t Key;
+        IDType ID;
+    } EntryType;
+
+    /**
+     * @brief Key of unused entries
+     */
+    static constexpr uint64_t EmptyKey = UINT64_MAX;
+
+    /**
+     * @brief Number of lattice points in each direction, i.e. the number of voxels plus one
+     */
+    int dimensions_lattice[3];
+
+    /**
+     * @brief Hash table. The size is always a power of two.
+     */
+    std::vector<EntryType> Table;
+
+    /**
+     * @brief Number of used entries in Table
+     */
+    size_t NumberOfEntries;
+
+    /**
+     * @brief Number of bits used for indexing Table
+     */
+    int TableBits;
+
+    /**
+     * @brief Gives the first slot in Table to probe for Key
+     */
+    inline size_t GiveSlot(uint64_t Key) const
+    {
+        return (size_t) ((Key * UINT64_C(11400714819323198485)) >> (64 - this->TableBits));
+    }
+
+    /**
+     * @brief Moves all entries to a new table with 2^TableBits slots
+     * @param TableBits Number of bits used for indexing the new table
+     */
+    void Rehash(int TableBits);
+
+public:
+    LatticeVertexMap();
+
+    /**
+     * @brief Clears the map and sets up the lattice
+     * @param Dimensions Number of voxels in each direction
+     * @param ExpectedNumberOfVertices Number of vertices to reserve space for
+     */
+    void Initialize(const int Dimensions[3], size_t ExpectedNumberOfVertices = 0);
+
+    /**
+     * @brief Gives the key of lattice point (i, j, k)
+     */
+    inline uint64_t GiveKey(int i, int j, int k) const
+    {
+        return (uint64_t) i + (uint64_t) this->dimensions_lattice[0] *
+                              ((uint64_t) j + (uint64_t) this->dimensions_lattice[1] * (uint64_t) k);
+    }
+
+    /**
+     * @brief Inserts a vertex ID at a lattice point unless the point already has one
+     * @param Key Key of lattice point
+     * @param ID ID to insert
+     * @return Pair of the ID stored at the lattice point and a flag telling if it was inserted
+     */
+    std::pair<IDType, bool> Insert(uint64_t Key, IDType ID);
+
+    /**
+     * @brief Finds the vertex ID at a lattice point
+     * @param Key Key of lattice point
+     * @return Vertex ID or -1 if none exists
+     */
+    IDType Find(uint64_t Key) const;
+
+    /**
+     * @brief Finds the vertex ID at lattice point (i, j, k)
+     * @return Vertex ID or -1 if none exists or if the point is outside the lattice
+     */
+    IDType Find(int i, int j, int k) const;
+
+    /**
+     * @brief Gives the number of vertices in the map
+     */
+    size_t GiveNumberOfVertices() const { return this->NumberOfEntries; }
+
+    /**
+     * @brief Removes all vertices and releases the memory used
+     */
+    void Clear();
+};
+}
+
+#endif // LATTICEVERTEXMAP_H
@@ -0,0 +1,146 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Allocates objects of type T from slabs holding many objects each. Released objects are destroyed and their
+ * memory is put on a free list, from which later allocations are served first. All objects still alive are destroyed
+ * and all slabs are freed when the pool is destroyed.
+ *
+ * Objects are never moved, i.e. pointers to objects stay valid until the object is released. The pool is not
+ * thread-safe.
+ */
+template <typename T>
+class ObjectPool
+{
+private:
+    /**
+     * @brief Number of objects per slab
+     */
+    static const size_t SlabSize = 1024;
+
+    /**
+     * @brief Memory of all slabs. Each slab holds SlabSize objects.
+     */
+    std::vector<T *> Slabs;
+
+    /**
+     * @brief Number of objects used in the last slab
+     */
+    size_t UsedInLastSlab;
+
+    /**
+     * @brief Released objects, available for reuse
+     */
+    std::vector<T *> FreeList;
+
+    /**
+     * @brief Total number of allocations
+     */
+    size_t NumberOfAllocations;
+
+    /**
+     * @brief Number of allocations served from the free list
+     */
+    size_t NumberOfReuses;
+
+public:
+    ObjectPool()
+    {
+        this->UsedInLastSlab = SlabSize;
+        this->NumberOfAllocations = 0;
+        this->NumberOfReuses = 0;
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    ~ObjectPool()
+    {
+        // Objects on the free list are already destroyed
+        std::sort(this->FreeList.begin(), this->FreeList.end());
+
+        for (size_t i = 0; i < this->Slabs.size(); i++) {
+            size_t Used = (i + 1 == this->Slabs.size()) ? this->UsedInLastSlab : SlabSize;
+            for (size_t j = 0; j < Used; j++) {
+                T *Object = this->Slabs[i] + j;
+                if (!std::binary_search(this->FreeList.begin(), this->FreeList.end(), Object)) {
+                    Object->~T();
+                }
+            }
+            ::operator delete(this->Slabs[i]);
+        }
+    }
+
+    /**
+     * @brief Creates a new object
+     * @param Arguments Arguments passed on to the constructor of T
+     * @return Pointer to object
+     */
+    template <typename... ArgumentTypes>
+    T *Allocate(ArgumentTypes &&... Arguments)
+    {
+        T *Memory;
+        if (!this->FreeList.empty()) {
+            Memory = this->FreeList.back();
+            this->FreeList.pop_back();
+            this->NumberOfReuses++;
+        } else {
+            if (this->UsedInLastSlab == SlabSize) {
+                this->Slabs.push_back(static_cast<T *>(::operator new(SlabSize * sizeof(T))));
+                this->UsedInLastSlab = 0;
+            }
+            Memory = this->Slabs.back() + this->UsedInLastSlab;
+            this->UsedInLastSlab++;
+        }
+        this->NumberOfAllocations++;
+        return new(Memory) T(std::forward<ArgumentTypes>(Arguments)...);
+    }
+
+    /**
+     * @brief Destroys an object allocated by this pool and makes its memory available for new objects
+     * @param Object Pointer to object
+     */
+    void Release(T *Object)
+    {
+        Object->~T();
+        this->FreeList.push_back(Object);
+    }
+
+    /**
+     * @brief Gives the total number of allocations made
+     */
+    size_t GiveNumberOfAllocations() const
+    { return this->NumberOfAllocations; }
+
+    /**
+     * @brief Gives the number of allocations that reused the memory of a released object
+     */
+    size_t GiveNumberOfReuses() const
+    { return this->NumberOfReuses; }
+
+    /**
+     * @brief Gives the number of objects currently alive
+     */
+    size_t GiveNumberOfObjects() const
+    { return this->GiveCapacity() - (SlabSize - this->UsedInLastSlab) - this->FreeList.size(); }
+
+    /**
+     * @brief Gives the number of objects the allocated slabs can hold
+     */
+    size_t GiveCapacity() const
+    { return this->Slabs.size() * SlabSize; }
+};
+
+}
+
+#endif // OBJECTPOOL_H
@@ -0,0 +1,22 @@
+#include "Parallel.h"
+
+namespace voxel2tet
+{
+
+static unsigned int NumberOfThreadsSetting = 0;
+
+unsigned int GiveNumberOfThreads()
+{
+    if (NumberOfThreadsSetting > 0) {
+        return NumberOfThreadsSetting;
+    }
+    unsigned int n = std::thread::hardware_concurrency();
+    return (n > 0) ? n : 1;
+}
+
+void SetNumberOfThreads(unsigned int NumberOfThreads)
+{
+    NumberOfThreadsSetting = NumberOfThreads;
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Gives the number of threads used by parallel sections. Defaults to the number of hardware threads.
+ */
+unsigned int GiveNumberOfThreads();
+
+/**
+ * @brief Sets the number of threads used by parallel sections
+ * @param NumberOfThreads Number of threads. If 0, the number of hardware threads is used.
+ */
+void SetNumberOfThreads(unsigned int NumberOfThreads);
+
+/**
+ * @brief Splits the range [Begin, End) into one contiguous part per thread and calls Function(ThreadID, PartBegin, PartEnd)
+ * for each part. Returns when all parts are done. Part ThreadID always precedes part ThreadID+1 in the range, which lets
+ * callers merge per-thread results in a deterministic order.
+ *
+ * @param Begin First index
+ * @param End One past the last index
+ * @param Function Callable as Function(unsigned int ThreadID, size_t PartBegin, size_t PartEnd)
+ * @param NumberOfParts Number of parts. If 0, GiveNumberOfThreads() is used.
+ */
+template <typename F>
+void ParallelForRanges(size_t Begin, size_t End, F Function, unsigned int NumberOfParts = 0)
+{
+    if (NumberOfParts == 0) {
+        NumberOfParts = GiveNumberOfThreads();
+    }
+    size_t N = (End > Begin) ? End - Begin : 0;
+    NumberOfParts = (unsigned int) std::max((size_t) 1, std::min((size_t) NumberOfParts, N));
+
+    if (NumberOfParts == 1) {
+        Function(0, Begin, End);
+        return;
+    }
+
+    std::vector<std::thread> Threads;
+    for (unsigned int t = 0; t < NumberOfParts; t++) {
+        size_t PartBegin = Begin + (N * t) / NumberOfParts;
+        size_t PartEnd = Begin + (N * (t + 1)) / NumberOfParts;
+        Threads.push_back(std::thread(Function, t, PartBegin, PartEnd));
+    }
+    for (std::thread &t : Threads) {
+        t.join();
+    }
+}
+
+}
+
+#endif // PARALLEL_H
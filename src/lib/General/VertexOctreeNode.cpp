@@ -7,10 +7,13 @@
 
 namespace voxel2tet
 {
-VertexOctreeNode::VertexOctreeNode(BoundingBoxType BoundingBox, std::vector<VertexType *> *Vertices, int level)
+VertexOctreeNode::VertexOctreeNode(BoundingBoxType BoundingBox, std::vector<VertexType *> *Vertices,
+                                   ObjectPool<VertexType> *VertexPool, MeshTopology *Topology, int level)
 {
     this->BoundingBox = BoundingBox;
     this->Vertices = Vertices;
+    this->VertexPool = VertexPool;
+    this->Topology = Topology;
     this->level = level;
 
     this->maxvertices = 20;
@@ -45,9 +48,9 @@ VertexType *VertexOctreeNode::FindVertexByCoords(double x, double y, double z)
     return NULL;
 }
 
-int VertexOctreeNode::AddVertex(double x, double y, double z)
+IDType VertexOctreeNode::AddVertex(double x, double y, double z)
 {
-    int newvertexid = -1;
+    IDType newvertexid = -1;
 
     // If this is a leaf, locate the node and return the ID
     if (this->children.size() == 0) {
@@ -67,8 +70,8 @@ int VertexOctreeNode::AddVertex(double x, double y, double z)
             throw std::out_of_range("Vertex is located outside the bounding box");
         }
 
-        this->Vertices->push_back(new VertexType(x, y, z));
-        int VertexID = this->Vertices->size() - 1;
+        this->Vertices->push_back(this->VertexPool->Allocate(this->Topology, x, y, z));
+        IDType VertexID = this->Vertices->size() - 1;
         this->Vertices->at(this->Vertices->size() - 1)->ID = VertexID;
         this->VertexIds.push_back(VertexID);
 
@@ -88,6 +91,38 @@ int VertexOctreeNode::AddVertex(double x, double y, double z)
     return newvertexid;
 }
 
+IDType VertexOctreeNode::AddNewVertex(double x, double y, double z)
+{
+    this->Vertices->push_back(this->VertexPool->Allocate(this->Topology, x, y, z));
+    IDType VertexID = this->Vertices->size() - 1;
+    this->Vertices->at(VertexID)->ID = VertexID;
+    this->InsertVertexID(VertexID);
+    return VertexID;
+}
+
+void VertexOctreeNode::InsertVertexID(IDType VertexID)
+{
+    VertexType *v = this->Vertices->at(VertexID);
+
+    if (this->children.size() > 0) {
+        for (VertexOctreeNode *child : this->children) {
+            if (child->IsInBoundingBox(v->get_c(0), v->get_c(1), v->get_c(2))) {
+                child->InsertVertexID(VertexID);
+                return;
+            }
+        }
+        throw std::out_of_range("Vertex is located outside the bounding box");
+    } else if (this->VertexIds.size() < std::size_t(this->maxvertices)) {
+        if (this->IsInBoundingBox(v->get_c(0), v->get_c(1), v->get_c(2)) == false) {
+            throw std::out_of_range("Vertex is located outside the bounding box");
+        }
+        this->VertexIds.push_back(VertexID);
+    } else {
+        this->split();
+        this->InsertVertexID(VertexID);
+    }
+}
+
 void VertexOctreeNode::split()
 {
     int newlevel = this->level + 1;
@@ -108,7 +143,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xmin;
     b1.minvalues[1] = ymin;
     b1.minvalues[2] = zmin;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xmax;
     b1.maxvalues[1] = yc;
@@ -116,7 +151,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xc;
     b1.minvalues[1] = ymin;
     b1.minvalues[2] = zmin;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xmax;
     b1.maxvalues[1] = yc;
@@ -124,7 +159,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xc;
     b1.minvalues[1] = ymin;
     b1.minvalues[2] = zc;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xc;
     b1.maxvalues[1] = yc;
@@ -132,7 +167,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xmin;
     b1.minvalues[1] = ymin;
     b1.minvalues[2] = zc;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xc;
     b1.maxvalues[1] = ymax;
@@ -140,7 +175,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xmin;
     b1.minvalues[1] = yc;
     b1.minvalues[2] = zmin;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xmax;
     b1.maxvalues[1] = ymax;
@@ -148,7 +183,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xc;
     b1.minvalues[1] = yc;
     b1.minvalues[2] = zmin;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xmax;
     b1.maxvalues[1] = ymax;
@@ -156,7 +191,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xc;
     b1.minvalues[1] = yc;
     b1.minvalues[2] = zc;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     b1.maxvalues[0] = xc;
     b1.maxvalues[1] = ymax;
@@ -164,7 +199,7 @@ void VertexOctreeNode::split()
     b1.minvalues[0] = xmin;
     b1.minvalues[1] = yc;
     b1.minvalues[2] = zc;
-    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, newlevel));
+    this->children.push_back(new VertexOctreeNode(b1, this->Vertices, this->VertexPool, this->Topology, newlevel));
 
     for (auto VertexID : this->VertexIds) {
         bool nodefound = false;
@@ -200,7 +235,7 @@ std::vector<VertexType *> VertexOctreeNode::GiveVerticesWithinSphere(double x, d
     std::vector<VertexType *> ResultList;
 
     if (this->children.size() == 0) { // If this is a leaf, check all vertices
-        for (int VertexId : this->VertexIds) {
+        for (IDType VertexId : this->VertexIds) {
             VertexType *v = this->Vertices->at(VertexId);
             double distance = std::sqrt((v->get_c(0) - x) * (v->get_c(0) - x) + (v->get_c(1) - y) * (v->get_c(1) - y) +
                                         (v->get_c(2) - z) * (v->get_c(2) - z));
@@ -263,8 +298,9 @@ void VertexOctreeNode::printself()
         }
     } else {
         for (auto VertexID : this->VertexIds) {
-            printf("%s\t#%u: (%f, %f, %f)\n", tab.c_str(), VertexID, this->Vertices->at(VertexID)->get_c(0),
-                   this->Vertices->at(VertexID)->get_c(1), this->Vertices->at(VertexID)->get_c(2));
+            printf("%s\t#%lld: (%f, %f, %f)\n", tab.c_str(), (long long) VertexID,
+                   this->Vertices->at(VertexID)->get_c(0), this->Vertices->at(VertexID)->get_c(1),
+                   this->Vertices->at(VertexID)->get_c(2));
         }
     }
 }
@@ -6,6 +6,7 @@
 #include <Importer.h>
 #include "MeshComponents.h"
 #include "MiscFunctions.h"
+#include "ObjectPool.h"
 
 namespace voxel2tet
 {
@@ -26,11 +27,14 @@ private:
 
     // List of indices pointing to this->Vertices contained within this node
     // TODO: Is it neccessary to use indices? Why not pionters?
-    std::vector<int> VertexIds;
+    std::vector<IDType> VertexIds;
 
     // Splits node into eight nodes
     void split();
 
+    // Stores the index of an existing vertex in the leaf containing it
+    void InsertVertexID(IDType VertexID);
+
     // Determines wether a coordinate is located within this node
     bool IsInBoundingBox(double x, double y, double z);
 
@@ -40,9 +44,12 @@ public:
      * @brief Contructor.
      * @param BoundingBox Bounding box for this node. If root node, this is equal to the bounding box of the complete structure.
      * @param Vertices Pointer to a list for vertices. This is the list of vertices used henceforth.
+     * @param VertexPool Pool from which new vertices are allocated
+     * @param Topology Topology to which new vertices are added
      * @param level Level of this node. 0 is for root. Other levels are taken care of by its parent.
      */
-    VertexOctreeNode(BoundingBoxType BoundingBox, std::vector<VertexType *> *Vertices, int level);
+    VertexOctreeNode(BoundingBoxType BoundingBox, std::vector<VertexType *> *Vertices, ObjectPool<VertexType> *VertexPool,
+                     MeshTopology *Topology, int level);
 
     ~VertexOctreeNode();
 
@@ -58,7 +65,17 @@ public:
      * @param z Z coordinate
      * @return Index of vertex
      */
-    int AddVertex(double x, double y, double z);
+    IDType AddVertex(double x, double y, double z);
+
+    /**
+     * @brief Adds a vertex at a specified coordinate to the structure without checking for an existing vertex at the
+     * coordinate. Use when vertices are known to be distinct, e.g. when they are welded by other means.
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Index of new vertex
+     */
+    IDType AddNewVertex(double x, double y, double z);
 
     /**
      * @brief List of vertices.
@@ -67,6 +84,16 @@ public:
      */
     std::vector<VertexType *> *Vertices;
 
+    /**
+     * @brief Pool from which new vertices are allocated. Shared by all nodes.
+     */
+    ObjectPool<VertexType> *VertexPool;
+
+    /**
+     * @brief Topology holding the coordinates of the vertices. Shared by all nodes.
+     */
+    MeshTopology *Topology;
+
     /**
      * @brief List of nodes owned by this node
      */
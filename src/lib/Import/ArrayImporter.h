@@ -0,0 +1,120 @@
+#ifndef ARRAYIMPORTER_H
+#define ARRAYIMPORTER_H
+
+#include <array>
+#include "Importer.h"
+#include "MiscFunctions.h"
+
+namespace voxel2tet
+{
+
+/**
+ * @brief The ArrayImporter class wraps voxel data held in memory by the caller. GiveMaterialIDByIndex reads directly from
+ * the caller's buffer, which must therefore outlive the importer. Any memory layout can be described by the strides,
+ * e.g. both C (z fastest) and Fortran (x fastest) ordering.
+ *
+ * GiveLabelGrid, which is called by the first FindSurfaces, copies all voxels into a LabelGrid, i.e. the material IDs
+ * are remapped to labels of 1, 2 or 4 bytes and the grid is padded with a ghost layer of one voxel on each side. The copy
+ * is held in Labels and is not freed, i.e. it takes memory in addition to the caller's buffer.
+ *
+ * T can be any 8, 16 or 32 bit integer type. The material IDs must fit in an int.
+ */
+template <typename T>
+class ArrayImporter : public Importer
+{
+private:
+    /**
+     * @brief Caller-owned voxel data
+     */
+    const T *Data;
+
+    /**
+     * @brief Distance in memory (in elements) between neighbouring voxels in each direction
+     */
+    size_t strides_data[3];
+
+    /**
+     * @brief Returns index in Data of voxel (xi, yi, zi) relative to the cut-out
+     */
+    inline size_t GiveDataIndex(int xi, int yi, int zi)
+    {
+        if (this->UseCutOut) {
+            xi += this->CutOut.minvalues[0];
+            yi += this->CutOut.minvalues[1];
+            zi += this->CutOut.minvalues[2];
+        }
+        return (size_t) xi * this->strides_data[0] + (size_t) yi * this->strides_data[1] +
+               (size_t) zi * this->strides_data[2];
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param Data Pointer to voxel data. Voxel (xi, yi, zi) is found at Data[xi*Strides[0] + yi*Strides[1] + zi*Strides[2]].
+     * @param Dimensions Number of voxels in (x, y, z) directions
+     * @param Origin Origin of voxel structure
+     * @param Spacing Size of one voxel
+     * @param Strides Distance in memory (in elements) between neighbouring voxels in each direction. If all are zero,
+     * the data is assumed to be contiguous with x fastest, i.e. Strides = {1, Dimensions[0], Dimensions[0]*Dimensions[1]}.
+     */
+    ArrayImporter(const T *Data, std::array<int, 3> Dimensions, std::array<double, 3> Origin,
+                  std::array<double, 3> Spacing, std::array<size_t, 3> Strides = {{0, 0, 0}})
+    {
+        this->Data = Data;
+        if ((Strides[0] == 0) && (Strides[1] == 0) && (Strides[2] == 0)) {
+            Strides = {{1, (size_t) Dimensions[0], (size_t) Dimensions[0] * Dimensions[1]}};
+        }
+        for (int i = 0; i < 3; i++) {
+            this->strides_data[i] = Strides[i];
+            this->dimensions_data[i] = Dimensions[i];
+            this->origin_data[i] = Origin[i];
+            this->spacing_data[i] = Spacing[i];
+            this->BoundingBox.minvalues[i] = Origin[i];
+            this->BoundingBox.maxvalues[i] = Origin[i] + Spacing[i] * Dimensions[i];
+        }
+    }
+
+    void LoadFile(std::string FileName)
+    {
+        STATUS("This class is made for wrapping voxel data in memory. Loading of files are not possible\n", 0);
+    }
+
+    virtual int GiveMaterialIDByIndex(int xi, int yi, int zi)
+    {
+        IntTriplet PseudoDimensions;
+        this->GiveDimensions(PseudoDimensions);
+
+        if (xi == -1) {
+            return -1;
+        } else if (xi >= PseudoDimensions[0]) {
+            return -2;
+        } else if (yi == -1) {
+            return -3;
+        } else if (yi == PseudoDimensions[1]) {
+            return -4;
+        } else if (zi == -1) {
+            return -5;
+        } else if (zi == PseudoDimensions[2]) {
+            return -6;
+        }
+
+        return (int) this->Data[this->GiveDataIndex(xi, yi, zi)];
+    }
+
+    /**
+     * @brief Gives the label grid. On the first call, a remapped and padded copy of the caller's buffer is made.
+     */
+    virtual LabelGridBase *GiveLabelGrid()
+    {
+        if (this->Labels == NULL) {
+            // Build labels directly from the caller's buffer
+            IntTriplet Dimensions;
+            this->GiveDimensions(Dimensions);
+            this->Labels = CreateLabelGrid(this->Data + this->GiveDataIndex(0, 0, 0), this->strides_data, Dimensions,
+                                           this->LabelLayout);
+        }
+        return this->Labels;
+    }
+};
+}
+#endif // ARRAYIMPORTER_H
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
 #include "CallbackImporter.h"
+#include "Parallel.h"
 
 namespace voxel2tet
 {
@@ -7,9 +12,11 @@ CallbackImporter::CallbackImporter(cbMaterialIDByCoordinate MaterialIdByCoordina
                                    std::array<int, 3> Dimensions)
 {
     this->MaterialByCoordinate = MaterialIdByCoordinateCallback;
+    this->MaterialsBySlab = NULL;
     this->spacing_data = Spacing;
     this->origin_data = Origin;
     this->dimensions_data = Dimensions;
+    this->UseCache = false;
 
     this->BoundingBox.minvalues = Origin;
     for (int i = 0; i < 3; i++) {
@@ -17,6 +24,13 @@ CallbackImporter::CallbackImporter(cbMaterialIDByCoordinate MaterialIdByCoordina
     }
 }
 
+CallbackImporter::CallbackImporter(cbMaterialIDsBySlab MaterialIDsBySlabCallback, std::array<double, 3> Origin,
+                                   std::array<double, 3> Spacing, std::array<int, 3> Dimensions) :
+    CallbackImporter((cbMaterialIDByCoordinate) NULL, Origin, Spacing, Dimensions)
+{
+    this->MaterialsBySlab = MaterialIDsBySlabCallback;
+}
+
 int CallbackImporter::GiveMaterialIDByCoordinate(double x, double y, double z)
 {
     if (x < (this->BoundingBox.minvalues[0] - eps)) {
@@ -33,11 +47,188 @@ int CallbackImporter::GiveMaterialIDByCoordinate(double x, double y, double z)
         return -6;
     }
 
+    if (!this->UseCache && this->MaterialsBySlab != NULL) {
+        // The batch callback can only be evaluated for whole slabs
+        this->SampleVoxels();
+    }
+
+    if (this->UseCache) {
+        // Find voxel containing the point. Points on the boundary (within eps) belong to the outermost voxels.
+        double coords[3] = {x, y, z};
+        int indices[3];
+        for (int i = 0; i < 3; i++) {
+            indices[i] = floor((coords[i] - this->origin_data[i]) / this->spacing_data[i]);
+            indices[i] = std::min(std::max(indices[i], 0), this->dimensions_data[i] - 1);
+        }
+        return this->Labels->GiveMaterialID(this->Labels->GiveIndex(indices[0], indices[1], indices[2]));
+    }
+
     return this->MaterialByCoordinate(x, y, z);
 }
 
+/**
+ * @brief Replaces material IDs by their indices in IDs, adding new IDs to IDs in order of appearance. Stops at the first
+ * ID whose index does not fit in T.
+ * @param Data Material IDs
+ * @param Count Number of material IDs in Data
+ * @param Indices [out] Indices of the material IDs
+ * @param IDs Distinct material IDs found so far
+ * @param IndexOf Index in IDs of each material ID in IDs
+ * @return Number of material IDs replaced
+ */
+template <typename T>
+static size_t IndexMaterialIDs(const int *Data, size_t Count, T *Indices, std::vector<int> &IDs,
+                               std::unordered_map<int, uint32_t> &IndexOf)
+{
+    // Neighbouring voxels mostly have the same material, so only look up the ID when it changes
+    int LastID = 0;
+    uint32_t LastIndex = 0;
+    bool HasLast = false;
+    for (size_t i = 0; i < Count; i++) {
+        if (!HasLast || (Data[i] != LastID)) {
+            auto it = IndexOf.find(Data[i]);
+            if (it == IndexOf.end()) {
+                if (IDs.size() > std::numeric_limits<T>::max()) {
+                    return i;
+                }
+                it = IndexOf.emplace(Data[i], (uint32_t) IDs.size()).first;
+                IDs.push_back(Data[i]);
+            }
+            LastID = Data[i];
+            LastIndex = it->second;
+            HasLast = true;
+        }
+        Indices[i] = (T) LastIndex;
+    }
+    return Count;
+}
+
+/**
+ * @brief Creates a label grid from indices into a list of material IDs in order of appearance, as given by
+ * IndexMaterialIDs. The indices are overwritten.
+ */
+template <typename T>
+static LabelGridBase *CreateLabelGridFromIndices(std::vector<T> &Indices, const std::vector<int> &IDs,
+                                                 const int Dimensions[3], LabelGrid_Layout Layout)
+{
+    // Renumber the indices such that they refer to the sorted list of IDs
+    std::vector<int> SortedIDs = IDs;
+    std::sort(SortedIDs.begin(), SortedIDs.end());
+    std::vector<T> Rank(IDs.size());
+    for (size_t i = 0; i < IDs.size(); i++) {
+        Rank[i] = (T) (std::lower_bound(SortedIDs.begin(), SortedIDs.end(), IDs[i]) - SortedIDs.begin());
+    }
+    for (T &Index : Indices) {
+        Index = Rank[Index];
+    }
+
+    size_t DataStrides[3] = {1, (size_t) Dimensions[0], (size_t) Dimensions[0] * Dimensions[1]};
+    return CreateLabelGrid(Indices.data(), DataStrides, Dimensions, Layout, &SortedIDs);
+}
+
+/**
+ * @brief Widens indices to a type of more bits
+ */
+template <typename S, typename T>
+static void WidenIndices(std::vector<S> &From, std::vector<T> &To)
+{
+    To.assign(From.begin(), From.end());
+    std::vector<S>().swap(From);
+}
+
+void CallbackImporter::SampleVoxels()
+{
+    STATUS("\tSample callback function in %zu voxels using %u threads\n",
+           (size_t) this->dimensions_data[0] * this->dimensions_data[1] * this->dimensions_data[2],
+           GiveNumberOfThreads());
+
+    int Dimensions[3] = {this->dimensions_data[0], this->dimensions_data[1], this->dimensions_data[2]};
+    size_t SliceSize = (size_t) Dimensions[0] * Dimensions[1];
+    size_t NumberOfVoxels = SliceSize * Dimensions[2];
+
+    // The voxels are sampled in chunks of slices. Each chunk is stored as indices into the list of distinct material IDs,
+    // using 8 bits per voxel and more only if there are too many materials. Hence, the material IDs of all voxels are
+    // never held in memory at once.
+    const size_t ChunkSize = (size_t) 1 << 24;
+    int ChunkSlices = (int) std::min((size_t) Dimensions[2], std::max(ChunkSize / std::max(SliceSize, (size_t) 1), (size_t) 1));
+    std::vector<int> Chunk(SliceSize * ChunkSlices);
+    std::vector<int> IDs;
+    std::unordered_map<int, uint32_t> IndexOf;
+    std::vector<uint8_t> Indices8(NumberOfVoxels);
+    std::vector<uint16_t> Indices16;
+    std::vector<uint32_t> Indices32;
+    int BytesPerIndex = 1;
+
+    for (int FirstChunkSlice = 0; FirstChunkSlice < Dimensions[2]; FirstChunkSlice += ChunkSlices) {
+        int NumberOfChunkSlices = std::min(ChunkSlices, Dimensions[2] - FirstChunkSlice);
+
+        ParallelForRanges(0, NumberOfChunkSlices, [&](unsigned int ThreadID, size_t FirstSlice, size_t LastSlice) {
+            if (this->MaterialsBySlab != NULL) {
+                std::array<double, 3> SlabOrigin;
+                for (int i = 0; i < 3; i++) {
+                    SlabOrigin[i] = this->origin_data[i] + this->spacing_data[i] * .5;
+                }
+                SlabOrigin[2] += this->spacing_data[2] * (FirstChunkSlice + FirstSlice);
+                std::array<int, 3> Extent = {{Dimensions[0], Dimensions[1], (int) (LastSlice - FirstSlice)}};
+                this->MaterialsBySlab(SlabOrigin, this->spacing_data, Extent, Chunk.data() + FirstSlice * SliceSize);
+                return;
+            }
+
+            for (size_t zi = FirstSlice; zi < LastSlice; zi++) {
+                int *Slice = Chunk.data() + zi * SliceSize;
+                double z = this->origin_data[2] + this->spacing_data[2] * (FirstChunkSlice + zi + .5);
+                for (int yi = 0; yi < Dimensions[1]; yi++) {
+                    double y = this->origin_data[1] + this->spacing_data[1] * (yi + .5);
+                    for (int xi = 0; xi < Dimensions[0]; xi++) {
+                        double x = this->origin_data[0] + this->spacing_data[0] * (xi + .5);
+                        Slice[yi * Dimensions[0] + xi] = this->MaterialByCoordinate(x, y, z);
+                    }
+                }
+            }
+        });
+
+        size_t First = (size_t) FirstChunkSlice * SliceSize;
+        size_t Count = (size_t) NumberOfChunkSlices * SliceSize;
+        size_t Done = 0;
+        while (Done < Count) {
+            if (BytesPerIndex == 1) {
+                Done += IndexMaterialIDs(Chunk.data() + Done, Count - Done, Indices8.data() + First + Done, IDs, IndexOf);
+            } else if (BytesPerIndex == 2) {
+                Done += IndexMaterialIDs(Chunk.data() + Done, Count - Done, Indices16.data() + First + Done, IDs, IndexOf);
+            } else {
+                Done += IndexMaterialIDs(Chunk.data() + Done, Count - Done, Indices32.data() + First + Done, IDs, IndexOf);
+            }
+            if (Done < Count) {
+                if (BytesPerIndex == 1) {
+                    WidenIndices(Indices8, Indices16);
+                } else {
+                    WidenIndices(Indices16, Indices32);
+                }
+                BytesPerIndex *= 2;
+            }
+        }
+    }
+
+    if (BytesPerIndex == 1) {
+        this->Labels = CreateLabelGridFromIndices(Indices8, IDs, Dimensions, this->LabelLayout);
+    } else if (BytesPerIndex == 2) {
+        this->Labels = CreateLabelGridFromIndices(Indices16, IDs, Dimensions, this->LabelLayout);
+    } else {
+        this->Labels = CreateLabelGridFromIndices(Indices32, IDs, Dimensions, this->LabelLayout);
+    }
+    this->UseCache = true;
+}
+
 int CallbackImporter::GiveMaterialIDByIndex(int xi, int yi, int zi)
 {
+    if (!this->UseCache && this->MaterialsBySlab != NULL) {
+        this->SampleVoxels();
+    }
+
+    if (this->UseCache) {
+        return Importer::GiveMaterialIDByIndex(xi, yi, zi);
+    }
+
     double x = this->origin_data[0] + this->spacing_data[0] * (xi + .5);
     double y = this->origin_data[1] + this->spacing_data[1] * (yi + .5);
     double z = this->origin_data[2] + this->spacing_data[2] * (zi + .5);
@@ -10,10 +10,21 @@ namespace voxel2tet
 
 /**
  * Definition of callback function. The return value is of integer type and reflects the material ID. The input parameters
- * of the functions are the coordinates (x, y, z).
+ * of the functions are the coordinates (x, y, z). If the material IDs are cached (see CallbackImporter::SampleVoxels), the
+ * function is called from several threads at once and must be thread-safe.
  */
 typedef int ( *cbMaterialIDByCoordinate )(double, double, double);
 
+/**
+ * Definition of batch callback function. The function fills MaterialIDs with the material IDs of a slab of voxels. The input
+ * parameters are the coordinate of the centre of the first voxel in the slab (Origin), the distance between voxel centres
+ * (Spacing) and the number of voxels in each direction of the slab (Extent). The material ID of voxel (xi, yi, zi) of the
+ * slab is stored at MaterialIDs[zi*Extent[0]*Extent[1] + yi*Extent[0] + xi]. Slabs are given to the function from several
+ * threads at once, hence it must be thread-safe.
+ */
+typedef void ( *cbMaterialIDsBySlab )(std::array<double, 3> Origin, std::array<double, 3> Spacing,
+                                      std::array<int, 3> Extent, int *MaterialIDs);
+
 /**
  * @brief The CallbackImporter class provides functionality to describe a genometry using a callback function. The callbackfunction
  * is given a coordinate and replies with a material ID.
@@ -23,11 +34,17 @@ class CallbackImporter : public Importer
 private:
     double eps = 1e-6;
     cbMaterialIDByCoordinate MaterialByCoordinate;
+    cbMaterialIDsBySlab MaterialsBySlab;
     std::array<double, 3> spacing_data;
     std::array<double, 3> origin_data;
     std::array<int, 3> dimensions_data;
     BoundingBoxType BoundingBox;
 
+    /**
+     * @brief Tells if the material IDs are read from the cached label grid instead of calling the callback function
+     */
+    bool UseCache;
+
 public:
     /**
      * @brief Special constructor for setting up a callback functions where material data is aquired.
@@ -39,12 +56,32 @@ public:
     CallbackImporter(cbMaterialIDByCoordinate MaterialIdByCoordinateCallback, std::array<double, 3> Origin,
                      std::array<double, 3> Spacing, std::array<int, 3> Dimensions);
 
+    /**
+     * @brief Constructor for setting up a batch callback function where material data is aquired one slab at a time. The
+     * voxels are sampled (see SampleVoxels) on first use.
+     * @param MaterialIDsBySlabCallback Pointer to batch callback function
+     * @param Origin Origin of voxel structure
+     * @param Spacing Size of one voxel
+     * @param Dimensions Number of voxels in (x, y, z) directions.
+     */
+    CallbackImporter(cbMaterialIDsBySlab MaterialIDsBySlabCallback, std::array<double, 3> Origin,
+                     std::array<double, 3> Spacing, std::array<int, 3> Dimensions);
+
     void LoadFile(std::string FileName)
     {
         STATUS("This class is made for loading voxeldata by evaluating functions. Loading of files are not possible\n",
                0);
     }
 
+    /**
+     * @brief Evaluates the callback function once at the centre of each voxel, using all threads, and caches the result in
+     * a label grid. All subsequent queries read from the cache, i.e. the geometry is represented by its voxels. The
+     * callback function must be thread-safe. The voxels are sampled in chunks of z-slices, and a batch callback function
+     * is called once per thread and chunk with a slab of z-slices. Only one chunk of material IDs is held in memory at a
+     * time, the rest is stored as indices into the list of distinct IDs (usually one byte per voxel).
+     */
+    void SampleVoxels();
+
     virtual int GiveMaterialIDByCoordinate(double x, double y, double z);
 
     virtual int GiveMaterialIDByIndex(int xi, int yi, int zi);
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cmath>
+#include <vector>
 
 #include "Dream3DDataReader.h"
 #include "MiscFunctions.h"
@@ -52,22 +53,61 @@ void Dream3DDataReader::LoadFile(std::string FileName)
         this->BoundingBox.maxvalues[i] = this->origin_data[i] + this->dimensions_data[i] * this->spacing_data[i];
     }
 
-    // Load voxel data.
+    // Load voxel data. Only the region given by the cut-out is read from the file.
+    this->ComputeLoadedRegion();
+
     H5::DataSet GrainIds = VoxelDataContainer->openGroup("CellData").openDataSet(this->MaterialGroup);
     H5::DataSpace space = GrainIds.getSpace();
 
     int Ndims = space.getSimpleExtentNdims();
-    hsize_t *dims = new hsize_t[Ndims];
-
-    space.getSimpleExtentDims(dims);
+    std::vector<hsize_t> dims(Ndims);
+    space.getSimpleExtentDims(dims.data());
 
-    int DataLength = 1;
+    hsize_t FileLength = 1;
     for (int i = 0; i < Ndims; i++) {
-        DataLength = DataLength * dims[i];
+        FileLength = FileLength * dims[i];
+    }
+
+    hsize_t DataLength = 1;
+    for (int i = 0; i < 3; i++) {
+        DataLength = DataLength * this->dimensions_loaded[i];
     }
 
+    if (DataLength == FileLength) {
+        GrainIdsData = (int *) malloc(sizeof(int) * DataLength);
+        GrainIds.read(GrainIdsData, H5::PredType::NATIVE_INT);
+        this->CompressLabels();
+        return;
+    }
+
+    if (Ndims >= 3) {
+        // Data stored as [z, y, x, (components)]. The region is a single block.
+        std::vector<hsize_t> start(Ndims, 0);
+        std::vector<hsize_t> count(Ndims, 1);
+        for (int i = 0; i < 3; i++) {
+            start[2 - i] = this->offset_loaded[i];
+            count[2 - i] = this->dimensions_loaded[i];
+        }
+        space.selectHyperslab(H5S_SELECT_SET, count.data(), start.data());
+    } else if (FileLength == hsize_t(this->dimensions_data[0]) * this->dimensions_data[1] * this->dimensions_data[2]) {
+        // Flat data. Select one strided set of rows (along x) for each z-slice in the region.
+        space.selectNone();
+        hsize_t stride = this->dimensions_data[0];
+        hsize_t count = this->dimensions_loaded[1];
+        hsize_t block = this->dimensions_loaded[0];
+        for (int zi = 0; zi < this->dimensions_loaded[2]; zi++) {
+            hsize_t start = hsize_t(zi + this->offset_loaded[2]) * this->dimensions_data[1] * this->dimensions_data[0] +
+                            hsize_t(this->offset_loaded[1]) * this->dimensions_data[0] + this->offset_loaded[0];
+            space.selectHyperslab(H5S_SELECT_OR, &count, &start, &stride, &block);
+        }
+    } else {
+        STATUS("Unexpected layout of dataset %s\n", this->MaterialGroup.c_str());
+        exit(-1);
+    }
 
+    H5::DataSpace memspace(1, &DataLength);
     GrainIdsData = (int *) malloc(sizeof(int) * DataLength);
-    GrainIds.read(GrainIdsData, H5::PredType::NATIVE_INT);
+    GrainIds.read(GrainIdsData, H5::PredType::NATIVE_INT, memspace, space);
+    this->CompressLabels();
 }
 }
@@ -1,4 +1,5 @@
 #include "Importer.h"
+#include "MiscFunctions.h"
 
 namespace voxel2tet
 {
@@ -65,15 +66,71 @@ int Importer::GiveMaterialIDByIndex(int xi, int yi, int zi)
         return -6;
     }
 
-    // If using Cut out, xi, yi and zi has to be shifted
-    if (this->UseCutOut) {
-        xi = xi + this->CutOut.minvalues[0];
-        yi = yi + this->CutOut.minvalues[1];
-        zi = zi + this->CutOut.minvalues[2];
+    return this->Labels->GiveMaterialID(this->Labels->GiveIndex(xi, yi, zi));
+}
+
+void Importer::CompressLabels()
+{
+    IntTriplet Dimensions, Offset;
+    this->GiveDimensions(Dimensions);
+    for (int i = 0; i < 3; i++) {
+        Offset[i] = (this->UseCutOut ? this->CutOut.minvalues[i] : 0) - this->offset_loaded[i];
+    }
+
+    this->Labels = CreateLabelGrid(this->GrainIdsData, this->dimensions_loaded, Offset, Dimensions, this->LabelLayout);
+    free(this->GrainIdsData);
+    this->GrainIdsData = NULL;
+
+    STATUS("\tVoxel data stored using %u bits per voxel (%zu distinct material IDs) in %s layout\n",
+           this->Labels->GiveBytesPerLabel() * 8, this->Labels->GiveNumberOfLabels(),
+           (this->LabelLayout == LL_BRICKED) ? "bricked" : "linear");
+}
+
+LabelGridBase *Importer::GiveLabelGrid()
+{
+    if (this->Labels == NULL) {
+        // No voxel data held in memory. Sample the material ID of each voxel once.
+        IntTriplet Dimensions, Offset = {0, 0, 0};
+        this->GiveDimensions(Dimensions);
+        std::vector<int> Data((size_t) Dimensions[0] * Dimensions[1] * Dimensions[2]);
+        size_t index = 0;
+        for (int zi = 0; zi < Dimensions[2]; zi++) {
+            for (int yi = 0; yi < Dimensions[1]; yi++) {
+                for (int xi = 0; xi < Dimensions[0]; xi++) {
+                    Data[index++] = this->GiveMaterialIDByIndex(xi, yi, zi);
+                }
+            }
+        }
+        this->Labels = CreateLabelGrid(Data.data(), Dimensions, Offset, Dimensions, this->LabelLayout);
+    }
+    return this->Labels;
+}
+
+void Importer::CheckCutOut()
+{
+    for (int i = 0; i < 3; i++) {
+        if (this->UseCutOut && ((this->CutOut.minvalues[i] < 0) || (this->CutOut.maxvalues[i] >= this->dimensions_data[i]) ||
+                                (this->CutOut.minvalues[i] > this->CutOut.maxvalues[i]))) {
+            STATUS("Cut-out does not fit in voxel data of dimensions %u x %u x %u\n", this->dimensions_data[0],
+                   this->dimensions_data[1], this->dimensions_data[2]);
+            exit(-1);
+        }
     }
+}
 
-    int index = zi * this->dimensions_data[1] * this->dimensions_data[0] + yi * this->dimensions_data[0] + xi;
-    return this->GrainIdsData[index];
+void Importer::ComputeLoadedRegion()
+{
+    this->CheckCutOut();
+
+    for (int i = 0; i < 3; i++) {
+        if (this->UseCutOut) {
+            this->offset_loaded[i] = this->CutOut.minvalues[i];
+            this->dimensions_loaded[i] = this->CutOut.maxvalues[i] - this->CutOut.minvalues[i] + 1;
+        } else {
+            this->offset_loaded[i] = 0;
+            this->dimensions_loaded[i] = this->dimensions_data[i];
+        }
+    }
 }
 
 int Importer::GiveMaterialIDByCoordinate(double x, double y, double z)
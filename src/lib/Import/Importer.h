@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include "Options.h"
+#include "LabelGrid.h"
 
 namespace voxel2tet
 {
@@ -80,20 +81,68 @@ protected:
     BoundingBoxType BoundingBox;
 
     /**
-     * @brief Voxel data
+     * @brief Number of voxels in each dimension of the region held in GrainIdsData
+     *
+     * Equals dimensions_data unless the importer only loaded a part of the file (see offset_loaded).
+     */
+    int dimensions_loaded[3];
+
+    /**
+     * @brief Index (in the complete voxel data) of the first voxel held in GrainIdsData
+     */
+    int offset_loaded[3];
+
+    /**
+     * @brief Voxel data as read from file
      *
      * The data is stored in an array of integers where each integer is the material ID at that index. The order of the data is
-     * X, Y, Z. I.e. the material id at index (xi, yi, zi) is given by
+     * X, Y, Z. I.e. the material id at index (xi, yi, zi), relative to offset_loaded, is given by
      *
-     * MatID(xi, yi, zi) = zi*dimensions_data[0]*dimensions_data[1]+yi*dimensions_data[0]+xi
+     * MatID(xi, yi, zi) = zi*dimensions_loaded[0]*dimensions_loaded[1]+yi*dimensions_loaded[0]+xi
      *
+     * Once loaded, the data is moved to Labels by CompressLabels and this array is freed.
      */
     int *GrainIdsData;
 
+    /**
+     * @brief Compact voxel data of the cut-out (or all data if no cut-out is used), padded with a ghost layer
+     */
+    LabelGridBase *Labels;
+
+    /**
+     * @brief Moves the cut-out of the data in GrainIdsData to a label grid using the narrowest label type possible. Should
+     * be called by the importer when the data is loaded.
+     */
+    void CompressLabels();
+
+    /**
+     * @brief Checks that the cut-out, if used, lies within the voxel data given by dimensions_data. Exits otherwise.
+     */
+    void CheckCutOut();
+
+    /**
+     * @brief Computes the region to load from file given the cut-out. The region is the cut-out or, if no cut-out is used,
+     * the complete voxel data. Voxels outside the cut-out are not needed since the ghost layer of Labels treats
+     * everything outside as boundary. Updates offset_loaded and dimensions_loaded. Exits if the cut-out does not fit in
+     * the voxel data, cf. CheckCutOut.
+     */
+    void ComputeLoadedRegion();
+
 public:
 
     Importer()
-    { UseCutOut = false; }
+    {
+        GrainIdsData = NULL;
+        Labels = NULL;
+        LabelLayout = LL_LINEAR;
+        UseCutOut = false;
+        CutOut.minvalues = {{0, 0, 0}};
+        CutOut.maxvalues = {{0, 0, 0}};
+        for (int i = 0; i < 3; i++) {
+            offset_loaded[i] = 0;
+            dimensions_loaded[i] = 0;
+        }
+    }
 
     /**
      * Tells if only a cutout of the data should be converted
@@ -105,11 +154,17 @@ public:
      */
     VoxelBoundingBoxType CutOut;
 
+    /**
+     * Memory layout of the label grid. Must be set before the file is loaded.
+     */
+    LabelGrid_Layout LabelLayout;
+
     /**
      * @brief Loads data from a file containing a voxel representation.
      *
      * As the file is loaded, internal variables for bounding boxes and such are updated. The data is stored in a private variable
-     * and is accessed by GiveMaterialIDByCoordinate and GiveMaterialIDByIndex.
+     * and is accessed by GiveMaterialIDByCoordinate and GiveMaterialIDByIndex. If UseCutOut is set before the file is loaded,
+     * importers supporting partial reads only load the cut-out into memory.
      *
      * @param FileName
      */
@@ -133,6 +188,13 @@ public:
      */
     virtual int GiveMaterialIDByIndex(int xi, int yi, int zi);
 
+    /**
+     * @brief Returns the material IDs of all voxels (within the cut-out) as a label grid padded with a ghost layer. If the
+     * importer does not hold the voxel data in memory, the grid is created by calling GiveMaterialIDByIndex once per voxel.
+     * @return Pointer to label grid owned by the importer
+     */
+    virtual LabelGridBase *GiveLabelGrid();
+
     /**
      * @brief Returns the dimensions of one voxel
      * @param spacing Array of 3
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <unordered_map>
+#include <climits>
+
+#include "LabelGrid.h"
+#include "Parallel.h"
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Tells if all labels in the box [First, Last] (inclusive, indices may be -1 or equal to the dimensions, i.e. in
+ * the ghost layer) are equal
+ */
+template <typename T>
+static bool IsUniformBox(const LabelGridBase *Grid, const int First[3], const int Last[3])
+{
+    const T *L = Grid->GiveLabels<T>();
+    const T Label = L[Grid->GiveIndex(First[0], First[1], First[2])];
+    for (int zi = First[2]; zi <= Last[2]; zi++) {
+        for (int yi = First[1]; yi <= Last[1]; yi++) {
+            bool Equal = true;
+            for (int xi = First[0]; xi <= Last[0]; xi = Grid->GiveRunEnd(xi)) {
+                const T *Run = L + Grid->GiveIndex(xi, yi, zi);
+                int RunLength = std::min(Grid->GiveRunEnd(xi), Last[0] + 1) - xi;
+                for (int x = 0; x < RunLength; x++) {
+                    Equal &= (Run[x] == Label);
+                }
+            }
+            if (!Equal) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+static void FindUniformBricks(const LabelGridBase *Grid, const int BrickDimensions[3], std::vector<uint8_t> &UniformBricks,
+                              size_t &UniformVoxels)
+{
+    const int *Dimensions = Grid->GiveDimensions();
+    const int BrickSize = LabelGridBase::BrickSize;
+
+    std::vector<size_t> ThreadUniformVoxels(std::max(1u, GiveNumberOfThreads()), 0);
+    ParallelForRanges(0, BrickDimensions[2], [&](unsigned int ThreadID, size_t FirstBrick, size_t LastBrick) {
+        for (int bk = (int) FirstBrick; bk < (int) LastBrick; bk++) {
+            for (int bj = 0; bj < BrickDimensions[1]; bj++) {
+                for (int bi = 0; bi < BrickDimensions[0]; bi++) {
+                    int Brick[3] = {bi, bj, bk};
+                    int First[3], Last[3];
+                    size_t Voxels = 1;
+                    for (int d = 0; d < 3; d++) {
+                        First[d] = Brick[d] * BrickSize - 1;
+                        Last[d] = std::min((Brick[d] + 1) * BrickSize, Dimensions[d]);
+                        Voxels *= (size_t) (Last[d] - First[d] - 1);
+                    }
+                    size_t index = (size_t) bi + (size_t) BrickDimensions[0] * ((size_t) bj + (size_t) BrickDimensions[1] * bk);
+                    UniformBricks[index] = IsUniformBox<T>(Grid, First, Last);
+                    if (UniformBricks[index]) {
+                        ThreadUniformVoxels[ThreadID] += Voxels;
+                    }
+                }
+            }
+        }
+    }, (unsigned int) ThreadUniformVoxels.size());
+
+    UniformVoxels = 0;
+    for (size_t n : ThreadUniformVoxels) {
+        UniformVoxels += n;
+    }
+}
+
+/**
+ * @brief Spreads the bits of x such that there are two zero bits between each bit
+ */
+static uint64_t SpreadBits(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+size_t LabelGridBase::SetupLayout(const int Dimensions[3], LabelGrid_Layout Layout)
+{
+    this->Layout = Layout;
+    for (int i = 0; i < 3; i++) {
+        this->Dimensions[i] = Dimensions[i];
+    }
+
+    if (Layout == LL_LINEAR) {
+        this->Strides[0] = 1;
+        this->Strides[1] = Dimensions[0] + 2;
+        this->Strides[2] = this->Strides[1] * (Dimensions[1] + 2);
+        return this->Strides[2] * (Dimensions[2] + 2);
+    }
+
+    this->Strides[0] = 1;
+    this->Strides[1] = BrickSize;
+    this->Strides[2] = BrickSize * BrickSize;
+
+    // Voxels -1, ..., Dimensions[i] are stored at BrickSize - 1, ..., Dimensions[i] + BrickSize
+    for (int i = 0; i < 3; i++) {
+        this->StoredBrickDimensions[i] = ((Dimensions[i] + BrickSize) >> BrickShift) + 1;
+    }
+    size_t NumberOfBricks = (size_t) this->StoredBrickDimensions[0] * this->StoredBrickDimensions[1] *
+                            this->StoredBrickDimensions[2];
+
+    // Order the bricks by their Morton codes
+    std::vector<std::pair<uint64_t, uint32_t> > Codes;
+    Codes.reserve(NumberOfBricks);
+    for (int bk = 0; bk < this->StoredBrickDimensions[2]; bk++) {
+        for (int bj = 0; bj < this->StoredBrickDimensions[1]; bj++) {
+            for (int bi = 0; bi < this->StoredBrickDimensions[0]; bi++) {
+                uint64_t Code = SpreadBits(bi) | (SpreadBits(bj) << 1) | (SpreadBits(bk) << 2);
+                Codes.push_back(std::make_pair(Code, (uint32_t) Codes.size()));
+            }
+        }
+    }
+    std::sort(Codes.begin(), Codes.end());
+
+    this->BrickSlots.resize(NumberOfBricks);
+    for (size_t i = 0; i < NumberOfBricks; i++) {
+        this->BrickSlots[Codes[i].second] = (uint32_t) i;
+    }
+
+    return NumberOfBricks << (3 * BrickShift);
+}
+
+void LabelGridBase::BuildBrickMap()
+{
+    for (int i = 0; i < 3; i++) {
+        this->BrickDimensions[i] = (this->Dimensions[i] + BrickSize - 1) / BrickSize;
+    }
+    this->UniformBricks.assign((size_t) this->BrickDimensions[0] * this->BrickDimensions[1] * this->BrickDimensions[2], 0);
+
+    switch (this->BytesPerLabel) {
+    case 1:
+        FindUniformBricks<uint8_t>(this, this->BrickDimensions, this->UniformBricks, this->UniformVoxels);
+        break;
+    case 2:
+        FindUniformBricks<uint16_t>(this, this->BrickDimensions, this->UniformBricks, this->UniformVoxels);
+        break;
+    default:
+        FindUniformBricks<uint32_t>(this, this->BrickDimensions, this->UniformBricks, this->UniformVoxels);
+        break;
+    }
+}
+
+size_t LabelGridBase::GiveNumberOfUniformBricks() const
+{
+    return (size_t) std::count(this->UniformBricks.begin(), this->UniformBricks.end(), 1);
+}
+
+template <typename S, typename F>
+static LabelGridBase *CreateTypedLabelGrid(const S *Data, const size_t DataStrides[3], const int Dimensions[3],
+                                           const std::vector<int> &OriginalIDs, F LabelOf, LabelGrid_Layout Layout)
+{
+    if (OriginalIDs.size() <= 0x100) {
+        return new LabelGrid<uint8_t>(Data, DataStrides, Dimensions, OriginalIDs, LabelOf, Layout);
+    } else if (OriginalIDs.size() <= 0x10000) {
+        return new LabelGrid<uint16_t>(Data, DataStrides, Dimensions, OriginalIDs, LabelOf, Layout);
+    } else {
+        return new LabelGrid<uint32_t>(Data, DataStrides, Dimensions, OriginalIDs, LabelOf, Layout);
+    }
+}
+
+/**
+ * @brief Calls Function(ID) for each material ID in the box
+ */
+template <typename S, typename F>
+static void ForEachInBox(const S *Data, const size_t DataStrides[3], const int Dimensions[3], F Function)
+{
+    for (int zi = 0; zi < Dimensions[2]; zi++) {
+        for (int yi = 0; yi < Dimensions[1]; yi++) {
+            const S *Row = Data + yi * DataStrides[1] + zi * DataStrides[2];
+            if (DataStrides[0] == 1) {
+                for (int xi = 0; xi < Dimensions[0]; xi++) {
+                    Function((int) Row[xi]);
+                }
+            } else {
+                for (int xi = 0; xi < Dimensions[0]; xi++) {
+                    Function((int) Row[xi * DataStrides[0]]);
+                }
+            }
+        }
+    }
+}
+
+template <typename S>
+LabelGridBase *CreateLabelGrid(const S *Data, const size_t DataStrides[3], const int Dimensions[3],
+                               LabelGrid_Layout Layout, const std::vector<int> *MaterialIDs)
+{
+    int MinID = INT_MAX, MaxID = INT_MIN;
+    ForEachInBox(Data, DataStrides, Dimensions, [&MinID, &MaxID](int ID) {
+        MinID = std::min(MinID, ID);
+        MaxID = std::max(MaxID, ID);
+    });
+
+    std::vector<int> OriginalIDs;
+    size_t N = (size_t) Dimensions[0] * Dimensions[1] * Dimensions[2];
+    long long Range = (N > 0) ? (long long) MaxID - MinID + 1 : 0;
+    LabelGridBase *Grid;
+
+    if (Range <= std::max((long long) N, (long long) 0x1000000)) {
+        // IDs are reasonably dense, use a table over the range of IDs
+        std::vector<unsigned int> Table(Range, 0);
+        ForEachInBox(Data, DataStrides, Dimensions, [&Table, MinID](int ID) {
+            Table[ID - MinID] = 1;
+        });
+        for (long long i = 0; i < Range; i++) {
+            if (Table[i]) {
+                Table[i] = OriginalIDs.size();
+                OriginalIDs.push_back(MinID + i);
+            }
+        }
+        if (MaterialIDs != NULL) {
+            for (int &ID : OriginalIDs) {
+                ID = (*MaterialIDs)[ID];
+            }
+        }
+        for (int i = 1; i <= 6; i++) {
+            OriginalIDs.push_back(-i);
+        }
+        Grid = CreateTypedLabelGrid(Data, DataStrides, Dimensions, OriginalIDs, [&Table, MinID](int ID) {
+            return Table[ID - MinID];
+        }, Layout);
+    } else {
+        // Sparse IDs, use a hash map
+        std::unordered_map<int, unsigned int> Map;
+        ForEachInBox(Data, DataStrides, Dimensions, [&Map](int ID) {
+            Map.emplace(ID, 0);
+        });
+        for (auto &m : Map) {
+            OriginalIDs.push_back(m.first);
+        }
+        std::sort(OriginalIDs.begin(), OriginalIDs.end());
+        for (unsigned int i = 0; i < OriginalIDs.size(); i++) {
+            Map[OriginalIDs[i]] = i;
+        }
+        if (MaterialIDs != NULL) {
+            for (int &ID : OriginalIDs) {
+                ID = (*MaterialIDs)[ID];
+            }
+        }
+        for (int i = 1; i <= 6; i++) {
+            OriginalIDs.push_back(-i);
+        }
+        Grid = CreateTypedLabelGrid(Data, DataStrides, Dimensions, OriginalIDs, [&Map](int ID) {
+            return Map.find(ID)->second;
+        }, Layout);
+    }
+
+    return Grid;
+}
+
+template LabelGridBase *CreateLabelGrid(const int8_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+template LabelGridBase *CreateLabelGrid(const uint8_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+template LabelGridBase *CreateLabelGrid(const int16_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+template LabelGridBase *CreateLabelGrid(const uint16_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+template LabelGridBase *CreateLabelGrid(const int32_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+template LabelGridBase *CreateLabelGrid(const uint32_t *, const size_t[3], const int[3], LabelGrid_Layout,
+                                       const std::vector<int> *);
+
+}
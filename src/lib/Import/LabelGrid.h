@@ -0,0 +1,444 @@
+#ifndef LABELGRID_H
+#define LABELGRID_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Memory layouts of label grids. LL_LINEAR stores the padded grid with x varying fastest, then y and z. LL_BRICKED
+ * stores bricks of LabelGridBase::BrickSize^3 voxels in Z-order (Morton order) with x varying fastest within each brick.
+ */
+enum LabelGrid_Layout
+{
+    LL_LINEAR, LL_BRICKED
+};
+
+/**
+ * @brief Storage of voxel labels using the narrowest possible integer type.
+ *
+ * The material IDs of the voxels are densely remapped to labels 0, 1, ..., N-1 in increasing order of the original IDs.
+ * Depending on N, the labels are stored using 8, 16 or 32 bits per voxel. The original IDs are given by a lookup table.
+ * Access is not virtual; the label width is resolved by a switch, which is well predicted since it never changes.
+ *
+ * The grid is padded with a ghost layer of one voxel on each side. The ghost voxels hold the labels N, ..., N+5 which
+ * correspond to the material IDs -1, ..., -6 returned by Importer::GiveMaterialIDByIndex outside the voxel data. Hence,
+ * the neighbours of any voxel can be read without checking the boundaries.
+ *
+ * The labels are either stored linearly (LL_LINEAR), where the neighbours of a voxel are found using the strides, or in
+ * bricks (LL_BRICKED), where all neighbours of a voxel but those on the far side of a brick face are within the same few
+ * cache lines. In the bricked layout, the strides give the distance between neighbours within a brick. The bricks are
+ * aligned such that voxel 0 is the first voxel of the second brick in each dimension, i.e. the ghost layer at -1 is
+ * stored in the last layer of the first brick.
+ *
+ * The voxels are also grouped in bricks of BrickSize^3 voxels. A brick is uniform if all its voxels and the one voxel
+ * halo around it have the same label. Voxels in uniform bricks have no neighbours of other materials and can be skipped
+ * when looking for interfaces.
+ */
+class LabelGridBase
+{
+public:
+    /**
+     * @brief Base 2 logarithm of the side length of the bricks
+     */
+    static const int BrickShift = 3;
+
+    /**
+     * @brief Side length of the bricks in voxels
+     */
+    static const int BrickSize = 1 << BrickShift;
+
+protected:
+    /**
+     * @brief Pointer to label data of the derived LabelGrid
+     */
+    const void *LabelData;
+
+    /**
+     * @brief Number of bytes per label (1, 2 or 4)
+     */
+    int BytesPerLabel;
+
+    /**
+     * @brief Lookup table from label to original material ID. The last six entries are the IDs of the ghost voxels.
+     */
+    std::vector<int> OriginalIDs;
+
+    /**
+     * @brief Number of voxels in each dimension, excluding the ghost layer
+     */
+    int Dimensions[3];
+
+    /**
+     * @brief Distance in memory between neighbouring voxels in each direction. In the bricked layout, only valid for
+     * neighbours in the same brick.
+     */
+    size_t Strides[3];
+
+    /**
+     * @brief Memory layout
+     */
+    LabelGrid_Layout Layout;
+
+    /**
+     * @brief Bricked layout: Number of stored bricks in each dimension, including bricks of the ghost layer
+     */
+    int StoredBrickDimensions[3];
+
+    /**
+     * @brief Bricked layout: Position in memory (in bricks) of each stored brick, x fastest
+     */
+    std::vector<uint32_t> BrickSlots;
+
+    /**
+     * @brief Sets up the layout of the label data for a grid of given dimensions
+     * @param Dimensions Number of voxels in each dimension, excluding the ghost layer
+     * @param Layout Memory layout
+     * @return Number of labels to store
+     */
+    size_t SetupLayout(const int Dimensions[3], LabelGrid_Layout Layout);
+
+    /**
+     * @brief Returns the index of voxel (xi, yi, zi) in the bricked layout
+     */
+    inline size_t GiveBrickedIndex(int xi, int yi, int zi) const
+    {
+        // Shift the indices such that the ghost layer is at the end of the first brick
+        unsigned int q[3] = {(unsigned int) (xi + BrickSize), (unsigned int) (yi + BrickSize),
+                             (unsigned int) (zi + BrickSize)};
+        size_t Brick = (q[0] >> BrickShift) + (size_t) this->StoredBrickDimensions[0] *
+                       ((q[1] >> BrickShift) + (size_t) this->StoredBrickDimensions[1] * (q[2] >> BrickShift));
+        return ((size_t) this->BrickSlots[Brick] << (3 * BrickShift)) + (q[0] & (BrickSize - 1)) +
+               ((q[1] & (BrickSize - 1)) << BrickShift) + ((q[2] & (BrickSize - 1)) << (2 * BrickShift));
+    }
+
+    /**
+     * @brief Number of bricks in each dimension
+     */
+    int BrickDimensions[3];
+
+    /**
+     * @brief One flag per brick, x fastest, telling if the brick is uniform
+     */
+    std::vector<uint8_t> UniformBricks;
+
+    /**
+     * @brief Number of voxels in uniform bricks
+     */
+    size_t UniformVoxels;
+
+    /**
+     * @brief Finds the uniform bricks. Called by the derived LabelGrid when the labels are set.
+     */
+    void BuildBrickMap();
+
+public:
+    virtual ~LabelGridBase()
+    {}
+
+    /**
+     * @brief Returns the index in the (padded) label data of voxel (xi, yi, zi). Valid for -1 <= xi <= Dimensions[0],
+     * and equivalently for yi and zi.
+     */
+    inline size_t GiveIndex(int xi, int yi, int zi) const
+    {
+        if (this->Layout == LL_BRICKED) {
+            return this->GiveBrickedIndex(xi, yi, zi);
+        }
+        return (size_t) (xi + 1) + (size_t) (yi + 1) * this->Strides[1] + (size_t) (zi + 1) * this->Strides[2];
+    }
+
+    /**
+     * @brief Returns the end of the run of voxels xi, xi + 1, ... (for fixed yi and zi) which are consecutive in memory,
+     * i.e. the end of the brick in the bricked layout. Valid for -1 <= xi <= Dimensions[0].
+     */
+    inline int GiveRunEnd(int xi) const
+    {
+        if (this->Layout == LL_BRICKED) {
+            return std::min(((xi >> BrickShift) + 1) << BrickShift, this->Dimensions[0] + 1);
+        }
+        return this->Dimensions[0] + 1;
+    }
+
+    /**
+     * @brief Returns the label (densely remapped ID) at index
+     * @param index Index in padded label data
+     * @return Label
+     */
+    inline unsigned int GiveLabel(size_t index) const
+    {
+        switch (this->BytesPerLabel) {
+        case 1:
+            return ((const uint8_t *) this->LabelData)[index];
+        case 2:
+            return ((const uint16_t *) this->LabelData)[index];
+        default:
+            return ((const uint32_t *) this->LabelData)[index];
+        }
+    }
+
+    /**
+     * @brief Returns the original material ID at index
+     * @param index Index in padded label data
+     * @return Material ID
+     */
+    inline int GiveMaterialID(size_t index) const
+    {
+        return this->OriginalIDs[this->GiveLabel(index)];
+    }
+
+    /**
+     * @brief Returns the original material ID of a label
+     * @param Label Label
+     * @return Material ID
+     */
+    inline int GiveOriginalID(unsigned int Label) const
+    {
+        return this->OriginalIDs[Label];
+    }
+
+    /**
+     * @brief Tells if a label belongs to the ghost layer, i.e. is outside the voxel data
+     */
+    inline bool IsOutside(unsigned int Label) const
+    {
+        return Label >= this->OriginalIDs.size() - 6;
+    }
+
+    /**
+     * @brief Tells if brick (bi, bj, bk) is uniform, i.e. if it and its one voxel halo only contain one label
+     */
+    inline bool IsUniformBrick(int bi, int bj, int bk) const
+    {
+        return this->UniformBricks[(size_t) bi + (size_t) this->BrickDimensions[0] *
+                                   ((size_t) bj + (size_t) this->BrickDimensions[1] * bk)] != 0;
+    }
+
+    /**
+     * @brief Tells if voxel (xi, yi, zi) is in a uniform brick. Valid for voxels inside the grid.
+     */
+    inline bool IsInUniformBrick(int xi, int yi, int zi) const
+    {
+        return this->IsUniformBrick(xi >> BrickShift, yi >> BrickShift, zi >> BrickShift);
+    }
+
+    /**
+     * @brief Returns the number of bricks
+     */
+    size_t GiveNumberOfBricks() const
+    {
+        return this->UniformBricks.size();
+    }
+
+    /**
+     * @brief Returns the number of uniform bricks
+     */
+    size_t GiveNumberOfUniformBricks() const;
+
+    /**
+     * @brief Returns the number of voxels in uniform bricks
+     */
+    size_t GiveNumberOfUniformVoxels() const
+    {
+        return this->UniformVoxels;
+    }
+
+    /**
+     * @brief Returns the labels as an array of type T. T must match GiveBytesPerLabel().
+     */
+    template <typename T>
+    const T *GiveLabels() const
+    {
+        return (const T *) this->LabelData;
+    }
+
+    /**
+     * @brief Returns the memory layout
+     */
+    LabelGrid_Layout GiveLayout() const
+    {
+        return this->Layout;
+    }
+
+    /**
+     * @brief Returns strides of the padded label data. In the bricked layout, the strides are only valid within a brick.
+     */
+    const size_t *GiveStrides() const
+    {
+        return this->Strides;
+    }
+
+    /**
+     * @brief Returns the number of voxels in each dimension, excluding the ghost layer
+     */
+    const int *GiveDimensions() const
+    {
+        return this->Dimensions;
+    }
+
+    /**
+     * @brief Returns the number of distinct material labels, excluding the ghost labels
+     */
+    size_t GiveNumberOfLabels() const
+    {
+        return this->OriginalIDs.size() - 6;
+    }
+
+    /**
+     * @brief Returns number of bytes used per voxel
+     */
+    int GiveBytesPerLabel() const
+    {
+        return this->BytesPerLabel;
+    }
+};
+
+/**
+ * @brief Label grid with labels of type T
+ */
+template <typename T>
+class LabelGrid : public LabelGridBase
+{
+private:
+    std::vector<T> Labels;
+
+public:
+    /**
+     * @brief Constructor. Copies a box of material IDs into a padded grid of labels.
+     * @param Data Material ID of the first voxel in the box
+     * @param DataStrides Distance in memory (in elements) between neighbouring voxels of Data in each direction
+     * @param Dimensions Dimensions of the box
+     * @param OriginalIDs Sorted list of the distinct material IDs in the box followed by the IDs of the ghost voxels
+     * @param LabelOf Function object giving the label of a material ID
+     * @param Layout Memory layout
+     */
+    template <typename S, typename F>
+    LabelGrid(const S *Data, const size_t DataStrides[3], const int Dimensions[3], std::vector<int> OriginalIDs,
+              F LabelOf, LabelGrid_Layout Layout)
+    {
+        this->Labels.resize(this->SetupLayout(Dimensions, Layout));
+        this->OriginalIDs = OriginalIDs;
+
+        // Labels of the ghost voxels for -x, +x, -y, +y, -z and +z. The order of the tests below gives the same ID as
+        // Importer::GiveMaterialIDByIndex for edges and corners of the ghost layer.
+        T Ghost[6];
+        for (int i = 0; i < 6; i++) {
+            Ghost[i] = (T) (OriginalIDs.size() - 6 + i);
+        }
+
+        // Sets the labels of voxels First <= xi < End of row (yi, zi), given a pointer to voxel First
+        auto FillRun = [&](T *Run, int First, int End, int yi, int zi) {
+            T *Row = Run - First;
+            if (First == -1) {
+                Row[-1] = Ghost[0];
+            }
+            if (End == Dimensions[0] + 1) {
+                Row[Dimensions[0]] = Ghost[1];
+            }
+            int InnerFirst = std::max(First, 0);
+            int InnerEnd = std::min(End, Dimensions[0]);
+
+            T RowGhost = 0;
+            bool GhostRow = true;
+            if (yi == -1) {
+                RowGhost = Ghost[2];
+            } else if (yi == Dimensions[1]) {
+                RowGhost = Ghost[3];
+            } else if (zi == -1) {
+                RowGhost = Ghost[4];
+            } else if (zi == Dimensions[2]) {
+                RowGhost = Ghost[5];
+            } else {
+                GhostRow = false;
+            }
+
+            if (GhostRow) {
+                for (int xi = InnerFirst; xi < InnerEnd; xi++) {
+                    Row[xi] = RowGhost;
+                }
+            } else {
+                const S *Source = Data + yi * DataStrides[1] + zi * DataStrides[2];
+                if (DataStrides[0] == 1) {
+                    for (int xi = InnerFirst; xi < InnerEnd; xi++) {
+                        Row[xi] = (T) LabelOf((int) Source[xi]);
+                    }
+                } else {
+                    for (int xi = InnerFirst; xi < InnerEnd; xi++) {
+                        Row[xi] = (T) LabelOf((int) Source[xi * DataStrides[0]]);
+                    }
+                }
+            }
+        };
+
+        if (Layout == LL_LINEAR) {
+            for (int zi = -1; zi <= Dimensions[2]; zi++) {
+                for (int yi = -1; yi <= Dimensions[1]; yi++) {
+                    FillRun(this->Labels.data() + this->GiveIndex(-1, yi, zi), -1, Dimensions[0] + 1, yi, zi);
+                }
+            }
+        } else {
+            // Fill one brick at a time. The parts of the bricks outside the ghost layer are not used.
+            for (int bk = 0; bk < this->StoredBrickDimensions[2]; bk++) {
+                for (int bj = 0; bj < this->StoredBrickDimensions[1]; bj++) {
+                    for (int bi = 0; bi < this->StoredBrickDimensions[0]; bi++) {
+                        // Range of voxels in the brick, clipped to the ghost layer
+                        int Brick[3] = {bi, bj, bk};
+                        int First[3], End[3];
+                        for (int d = 0; d < 3; d++) {
+                            First[d] = std::max(Brick[d] * BrickSize - BrickSize, -1);
+                            End[d] = std::min(Brick[d] * BrickSize, Dimensions[d] + 1);
+                        }
+                        for (int zi = First[2]; zi < End[2]; zi++) {
+                            for (int yi = First[1]; yi < End[1]; yi++) {
+                                FillRun(this->Labels.data() + this->GiveIndex(First[0], yi, zi), First[0], End[0], yi, zi);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        this->LabelData = this->Labels.data();
+        this->BytesPerLabel = sizeof(T);
+        this->BuildBrickMap();
+    }
+};
+
+/**
+ * @brief Creates a label grid of the narrowest type able to hold all distinct material IDs in a box of strided data.
+ * Instantiated for 8, 16 and 32 bit signed and unsigned integers. The material IDs must fit in an int.
+ * @param Data Material ID of the first voxel in the box
+ * @param DataStrides Distance in memory (in elements) between neighbouring voxels of Data in each direction
+ * @param Dimensions Dimensions of the box
+ * @param Layout Memory layout of the label grid
+ * @param MaterialIDs If given, Data holds indices into this sorted list of material IDs instead of the IDs themselves
+ * @return Pointer to new label grid
+ */
+template <typename S>
+LabelGridBase *CreateLabelGrid(const S *Data, const size_t DataStrides[3], const int Dimensions[3],
+                               LabelGrid_Layout Layout = LL_LINEAR, const std::vector<int> *MaterialIDs = NULL);
+
+/**
+ * @brief Creates a label grid of the narrowest type able to hold all distinct material IDs in a box of Data
+ * @param Data Material IDs of the voxels, x fastest
+ * @param DataDimensions Dimensions of Data
+ * @param Offset Index in Data of the first voxel in the box
+ * @param Dimensions Dimensions of the box
+ * @param Layout Memory layout of the label grid
+ * @return Pointer to new label grid
+ */
+inline LabelGridBase *CreateLabelGrid(const int *Data, const int DataDimensions[3], const int Offset[3],
+                                      const int Dimensions[3], LabelGrid_Layout Layout = LL_LINEAR)
+{
+    size_t DataStrides[3] = {1, (size_t) DataDimensions[0], (size_t) DataDimensions[0] * DataDimensions[1]};
+    return CreateLabelGrid(Data + Offset[0] + Offset[1] * DataStrides[1] + Offset[2] * DataStrides[2], DataStrides,
+                           Dimensions, Layout);
+}
+
+}
+
+#endif // LABELGRID_H
@@ -0,0 +1,521 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <climits>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <zlib.h>
+
+#include "Parallel.h"
+
+#include "NRRDReader.h"
+
+namespace voxel2tet
+{
+
+/**
+ * @brief Converts N integers of type T with given byte order to material IDs. Values are assembled byte by byte, which is
+ * independent of the endianness of the host.
+ */
+template <typename T>
+static void ConvertValues(const unsigned char *Source, int *Destination, size_t N, bool BigEndian)
+{
+    const size_t s = sizeof(T);
+    if (BigEndian) {
+        for (size_t i = 0; i < N; i++) {
+            uint32_t Value = 0;
+            for (size_t j = 0; j < s; j++) {
+                Value = (Value << 8) | Source[i * s + j];
+            }
+            Destination[i] = (int) (T) Value;
+        }
+    } else {
+        for (size_t i = 0; i < N; i++) {
+            uint32_t Value = 0;
+            for (size_t j = 0; j < s; j++) {
+                Value = (Value << 8) | Source[i * s + s - 1 - j];
+            }
+            Destination[i] = (int) (T) Value;
+        }
+    }
+}
+
+/**
+ * @brief Parses a vector on the form (a,b,c) into Values
+ */
+static std::vector<double> ParseVector(std::string Text)
+{
+    for (char &c : Text) {
+        if ((c == '(') || (c == ')') || (c == ',')) {
+            c = ' ';
+        }
+    }
+    std::vector<double> Values;
+    for (std::string s : SplitString(Text, ' ')) {
+        if (s.length() > 0) {
+            Values.push_back(std::stod(s));
+        }
+    }
+    return Values;
+}
+
+/**
+ * @brief Maps a file into memory
+ * @param FileName Name of file
+ * @param FileSize Output. Size of file.
+ * @return Pointer to mapped file
+ */
+static const unsigned char *MapFile(std::string FileName, size_t &FileSize)
+{
+    int fd = open(FileName.c_str(), O_RDONLY);
+    struct stat FileStat;
+    if ((fd == -1) || (fstat(fd, &FileStat) == -1)) {
+        STATUS("Cound not open input file %s\n", FileName.c_str());
+        exit(-1);
+    }
+
+    FileSize = FileStat.st_size;
+    void *Map = mmap(NULL, FileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (Map == MAP_FAILED) {
+        STATUS("Could not memory map input file %s\n", FileName.c_str());
+        exit(-1);
+    }
+    madvise(Map, FileSize, MADV_SEQUENTIAL);
+    return (const unsigned char *) Map;
+}
+
+NRRDReader::NRRDReader()
+{
+    this->ScalarSize = 0;
+    this->ScalarSigned = false;
+    this->BigEndian = false;
+    this->Compressed = false;
+    this->DataOffset = 0;
+}
+
+void NRRDReader::ParseHeader(std::string FileName)
+{
+    std::ifstream Input;
+    Input.open(FileName, std::ios::in | std::ios::binary);
+
+    if (!Input.is_open()) {
+        STATUS("Cound not open input file %s\n", FileName.c_str());
+        exit(-1);
+    }
+
+    std::string line;
+    std::getline(Input, line);
+    if (line.compare(0, 4, "NRRD") != 0) {
+        STATUS("File %s is not an NRRD file\n", FileName.c_str());
+        exit(-1);
+    }
+
+    int Dimension = 0;
+    long long ByteSkip = 0;
+    int LineSkip = 0;
+    bool SpacingGiven = false;
+    std::vector<double> Origin = {0.0, 0.0, 0.0};
+    std::string Encoding = "raw";
+    std::string Endian = "little";
+    std::string DataFile = "";
+
+    for (int i = 0; i < 3; i++) {
+        this->spacing_data[i] = 1.0;
+    }
+
+    while (std::getline(Input, line)) {
+        if ((line.length() > 0) && (line.back() == '\r')) {
+            line.pop_back();
+        }
+        if (line.length() == 0) {
+            // End of header. Attached data follows.
+            break;
+        }
+        if (line[0] == '#') {
+            continue;
+        }
+
+        size_t Colon = line.find(": ");
+        if ((Colon == std::string::npos) || (line.find(":=") < Colon)) {
+            // Key/value pairs are not used
+            continue;
+        }
+        std::string Field = line.substr(0, Colon);
+        std::string Description = line.substr(Colon + 2);
+        std::vector<std::string> Strings = SplitString(Description, ' ');
+
+        if (Field == "type") {
+            std::string Type = Description;
+            if ((Type == "signed char") || (Type == "int8") || (Type == "int8_t")) {
+                this->ScalarSize = 1;
+                this->ScalarSigned = true;
+            } else if ((Type == "uchar") || (Type == "unsigned char") || (Type == "uint8") || (Type == "uint8_t")) {
+                this->ScalarSize = 1;
+                this->ScalarSigned = false;
+            } else if ((Type == "short") || (Type == "short int") || (Type == "signed short") ||
+                       (Type == "signed short int") || (Type == "int16") || (Type == "int16_t")) {
+                this->ScalarSize = 2;
+                this->ScalarSigned = true;
+            } else if ((Type == "ushort") || (Type == "unsigned short") || (Type == "unsigned short int") ||
+                       (Type == "uint16") || (Type == "uint16_t")) {
+                this->ScalarSize = 2;
+                this->ScalarSigned = false;
+            } else if ((Type == "int") || (Type == "signed int") || (Type == "int32") || (Type == "int32_t")) {
+                this->ScalarSize = 4;
+                this->ScalarSigned = true;
+            } else if ((Type == "uint") || (Type == "unsigned int") || (Type == "uint32") || (Type == "uint32_t")) {
+                this->ScalarSize = 4;
+                this->ScalarSigned = false;
+            } else {
+                STATUS("Type %s not supported in NRRD files\n", Type.c_str());
+                exit(-1);
+            }
+        } else if (Field == "dimension") {
+            Dimension = std::stoi(Description);
+        } else if (Field == "sizes") {
+            if (Strings.size() != 3) {
+                STATUS("Can only handle three dimensional NRRD files\n", 0);
+                exit(-1);
+            }
+            for (int i = 0; i < 3; i++) {
+                this->dimensions_data[i] = std::stoi(Strings[i]);
+            }
+        } else if (Field == "spacings") {
+            for (int i = 0; (i < 3) && (i < (int) Strings.size()); i++) {
+                this->spacing_data[i] = std::stod(Strings[i]);
+            }
+            SpacingGiven = true;
+        } else if (Field == "space directions") {
+            // One vector per axis. Only the length of each vector is used, i.e. the axes are assumed to be aligned with
+            // the coordinate system.
+            std::vector<double> Directions = ParseVector(Description);
+            if (Directions.size() != 9) {
+                STATUS("Could not parse space directions %s\n", Description.c_str());
+                exit(-1);
+            }
+            for (int i = 0; i < 3; i++) {
+                double *d = &Directions[i * 3];
+                this->spacing_data[i] = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            }
+            SpacingGiven = true;
+        } else if (Field == "space origin") {
+            Origin = ParseVector(Description);
+            if (Origin.size() != 3) {
+                STATUS("Could not parse space origin %s\n", Description.c_str());
+                exit(-1);
+            }
+        } else if (Field == "encoding") {
+            Encoding = Description;
+        } else if (Field == "endian") {
+            Endian = Description;
+        } else if ((Field == "data file") || (Field == "datafile")) {
+            DataFile = Description;
+        } else if ((Field == "byte skip") || (Field == "byteskip")) {
+            ByteSkip = std::stoll(Description);
+        } else if ((Field == "line skip") || (Field == "lineskip")) {
+            LineSkip = std::stoi(Description);
+        } else {
+            LOG("Field %s ignored\n", Field.c_str());
+        }
+    }
+
+    if (Dimension != 3) {
+        STATUS("Can only handle three dimensional NRRD files\n", 0);
+        exit(-1);
+    }
+    if (this->ScalarSize == 0) {
+        STATUS("No type given in %s\n", FileName.c_str());
+        exit(-1);
+    }
+    if (!SpacingGiven) {
+        LOG("No spacing given, use unit spacing\n", 0);
+    }
+
+    if (Encoding == "raw") {
+        this->Compressed = false;
+    } else if ((Encoding == "gzip") || (Encoding == "gz")) {
+        this->Compressed = true;
+    } else {
+        STATUS("Encoding %s not supported in NRRD files\n", Encoding.c_str());
+        exit(-1);
+    }
+    this->BigEndian = (Endian == "big");
+
+    // Locate data
+    if (DataFile == "") {
+        this->DataFileName = FileName;
+        this->DataOffset = Input.tellg();
+    } else {
+        if ((DataFile == "LIST") || (DataFile.find('%') != std::string::npos)) {
+            STATUS("Data split over several files is not supported\n", 0);
+            exit(-1);
+        }
+        // Paths are relative to the header file
+        size_t Slash = FileName.rfind('/');
+        if ((DataFile[0] != '/') && (Slash != std::string::npos)) {
+            DataFile = FileName.substr(0, Slash + 1) + DataFile;
+        }
+        this->DataFileName = DataFile;
+        this->DataOffset = 0;
+    }
+
+    if (LineSkip > 0) {
+        if (this->Compressed) {
+            STATUS("Line skip is not supported for compressed NRRD files\n", 0);
+            exit(-1);
+        }
+        std::ifstream DataInput(this->DataFileName, std::ios::in | std::ios::binary);
+        DataInput.seekg(this->DataOffset);
+        for (int i = 0; i < LineSkip; i++) {
+            std::getline(DataInput, line);
+        }
+        this->DataOffset = DataInput.tellg();
+    }
+
+    if (ByteSkip == -1) {
+        if (this->Compressed) {
+            STATUS("Byte skip -1 is not supported for compressed NRRD files\n", 0);
+            exit(-1);
+        }
+        // Data is found at the end of the file
+        size_t N = (size_t) this->dimensions_data[0] * this->dimensions_data[1] * this->dimensions_data[2];
+        std::ifstream DataInput(this->DataFileName, std::ios::in | std::ios::binary | std::ios::ate);
+        this->DataOffset = (size_t) DataInput.tellg() - N * this->ScalarSize;
+    } else if (ByteSkip > 0) {
+        if (this->Compressed) {
+            STATUS("Byte skip is not supported for compressed NRRD files\n", 0);
+            exit(-1);
+        }
+        this->DataOffset = this->DataOffset + ByteSkip;
+    }
+
+    // Values are given at the centres of the voxels
+    for (int i = 0; i < 3; i++) {
+        this->origin_data[i] = Origin[i] - this->spacing_data[i] / 2.0;
+        this->BoundingBox.minvalues[i] = this->origin_data[i];
+        this->BoundingBox.maxvalues[i] = this->origin_data[i] + this->dimensions_data[i] * this->spacing_data[i];
+    }
+}
+
+void NRRDReader::StoreValues(const unsigned char *Bytes, size_t First, size_t Count)
+{
+    size_t nx = this->dimensions_data[0];
+    size_t ny = this->dimensions_data[1];
+
+    // Process one row (or part of a row) at a time
+    while (Count > 0) {
+        size_t xi = First % nx;
+        size_t yi = (First / nx) % ny;
+        size_t zi = First / (nx * ny);
+        size_t Run = std::min(nx - xi, Count);
+
+        long yl = (long) yi - this->offset_loaded[1];
+        long zl = (long) zi - this->offset_loaded[2];
+        if ((yl >= 0) && (yl < this->dimensions_loaded[1]) && (zl >= 0) && (zl < this->dimensions_loaded[2])) {
+            size_t Begin = std::max(xi, (size_t) this->offset_loaded[0]);
+            size_t End = std::min(xi + Run, (size_t) (this->offset_loaded[0] + this->dimensions_loaded[0]));
+            if (Begin < End) {
+                int *Destination = this->GrainIdsData +
+                                   ((size_t) zl * this->dimensions_loaded[1] + yl) * this->dimensions_loaded[0] +
+                                   (Begin - this->offset_loaded[0]);
+                const unsigned char *Source = Bytes + (Begin - xi) * this->ScalarSize;
+                size_t N = End - Begin;
+                if (this->ScalarSize == 1) {
+                    if (this->ScalarSigned) {
+                        ConvertValues<int8_t>(Source, Destination, N, this->BigEndian);
+                    } else {
+                        ConvertValues<uint8_t>(Source, Destination, N, this->BigEndian);
+                    }
+                } else if (this->ScalarSize == 2) {
+                    if (this->ScalarSigned) {
+                        ConvertValues<int16_t>(Source, Destination, N, this->BigEndian);
+                    } else {
+                        ConvertValues<uint16_t>(Source, Destination, N, this->BigEndian);
+                    }
+                } else {
+                    if (this->ScalarSigned) {
+                        ConvertValues<int32_t>(Source, Destination, N, this->BigEndian);
+                    } else {
+                        ConvertValues<uint32_t>(Source, Destination, N, this->BigEndian);
+                    }
+                }
+            }
+        }
+
+        Bytes = Bytes + Run * this->ScalarSize;
+        First = First + Run;
+        Count = Count - Run;
+    }
+}
+
+void NRRDReader::LoadCompressed(const unsigned char *Source, size_t SourceSize)
+{
+    size_t N = (size_t) this->dimensions_data[0] * this->dimensions_data[1] * this->dimensions_data[2];
+    size_t TotalBytes = N * this->ScalarSize;
+    size_t BlockSize = std::min(((size_t) 32 << 20) / this->ScalarSize * this->ScalarSize, TotalBytes);
+
+    z_stream Stream;
+    Stream.zalloc = Z_NULL;
+    Stream.zfree = Z_NULL;
+    Stream.opaque = Z_NULL;
+    Stream.next_in = Z_NULL;
+    Stream.avail_in = 0;
+    // Window size 15 plus 32 for automatic detection of gzip or zlib header
+    if (inflateInit2(&Stream, 15 + 32) != Z_OK) {
+        STATUS("Could not initialize zlib\n", 0);
+        exit(-1);
+    }
+
+    const unsigned char *Input = Source;
+    size_t InputLeft = SourceSize;
+    std::string Error = "";
+
+    // Decompresses into Block until it is full or the stream ends. Returns the number of bytes produced.
+    auto Inflate = [&](unsigned char *Block, size_t Size) -> size_t {
+        Stream.next_out = Block;
+        size_t Produced = 0;
+        while ((Produced < Size) && (Error == "")) {
+            if ((Stream.avail_in == 0) && (InputLeft > 0)) {
+                uInt Chunk = (uInt) std::min(InputLeft, (size_t) UINT_MAX);
+                Stream.next_in = (Bytef *) Input;
+                Stream.avail_in = Chunk;
+                Input = Input + Chunk;
+                InputLeft = InputLeft - Chunk;
+            }
+            uInt OutSize = (uInt) std::min(Size - Produced, (size_t) UINT_MAX);
+            Stream.avail_out = OutSize;
+            int Status = inflate(&Stream, Z_NO_FLUSH);
+            Produced = Produced + (OutSize - Stream.avail_out);
+            if (Status == Z_STREAM_END) {
+                if ((Stream.avail_in == 0) && (InputLeft == 0)) {
+                    break;
+                }
+                // Concatenated gzip members
+                inflateReset(&Stream);
+            } else if ((Status == Z_BUF_ERROR) && (Stream.avail_in == 0) && (InputLeft == 0)) {
+                break;
+            } else if ((Status != Z_OK) && (Status != Z_BUF_ERROR)) {
+                Error = (Stream.msg != NULL) ? Stream.msg : "zlib error";
+            }
+        }
+        return Produced;
+    };
+
+    // Double buffering: one block is decompressed while the other is converted
+    std::vector<unsigned char> Blocks[2] = {std::vector<unsigned char>(BlockSize), std::vector<unsigned char>(BlockSize)};
+    size_t Filled[2] = {0, 0};
+    bool Ready[2] = {false, false};
+    std::mutex Mutex;
+    std::condition_variable Condition;
+
+    auto Producer = [&]() {
+        size_t Total = 0;
+        for (unsigned int b = 0; ; b = 1 - b) {
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                Condition.wait(Lock, [&]() { return !Ready[b]; });
+            }
+            size_t Size = (Total < TotalBytes) ? Inflate(Blocks[b].data(), std::min(BlockSize, TotalBytes - Total)) : 0;
+            Total = Total + Size;
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Filled[b] = Size;
+                Ready[b] = true;
+            }
+            Condition.notify_all();
+            if (Size == 0) {
+                return;
+            }
+        }
+    };
+
+    bool Threaded = GiveNumberOfThreads() > 1;
+    std::thread ProducerThread;
+    if (Threaded) {
+        ProducerThread = std::thread(Producer);
+    }
+
+    size_t Stored = 0;
+    for (unsigned int b = 0; ; b = 1 - b) {
+        size_t Size;
+        if (Threaded) {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            Condition.wait(Lock, [&]() { return Ready[b]; });
+            Size = Filled[b];
+        } else {
+            Size = (Stored * this->ScalarSize < TotalBytes) ?
+                   Inflate(Blocks[b].data(), std::min(BlockSize, TotalBytes - Stored * this->ScalarSize)) : 0;
+        }
+
+        if (Size == 0) {
+            break;
+        }
+
+        size_t Count = Size / this->ScalarSize;
+        this->StoreValues(Blocks[b].data(), Stored, Count);
+        Stored = Stored + Count;
+
+        if (Threaded) {
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Ready[b] = false;
+            }
+            Condition.notify_all();
+        }
+    }
+
+    if (Threaded) {
+        ProducerThread.join();
+    }
+    inflateEnd(&Stream);
+
+    if (Error != "") {
+        STATUS("Could not decompress data: %s\n", Error.c_str());
+        exit(-1);
+    }
+    if (Stored < N) {
+        STATUS("Unexpected end of compressed data after %zu of %zu values\n", Stored, N);
+        exit(-1);
+    }
+}
+
+void NRRDReader::LoadFile(std::string FileName)
+{
+    this->ParseHeader(FileName);
+
+    LOG("Read data from %s\n", this->DataFileName.c_str());
+
+    // Only keep the cut-out in memory. This also checks that the cut-out fits in the data before anything is allocated.
+    this->ComputeLoadedRegion();
+    this->GrainIdsData = (int *) malloc(sizeof(int) * (size_t) this->dimensions_loaded[0] * this->dimensions_loaded[1] *
+                                        this->dimensions_loaded[2]);
+
+    size_t FileSize;
+    const unsigned char *Map = MapFile(this->DataFileName, FileSize);
+    size_t N = (size_t) this->dimensions_data[0] * this->dimensions_data[1] * this->dimensions_data[2];
+
+    if (this->DataOffset > FileSize) {
+        STATUS("File %s is truncated\n", this->DataFileName.c_str());
+        exit(-1);
+    }
+
+    if (this->Compressed) {
+        this->LoadCompressed(Map + this->DataOffset, FileSize - this->DataOffset);
+    } else {
+        if (this->DataOffset + N * this->ScalarSize > FileSize) {
+            STATUS("File %s is truncated\n", this->DataFileName.c_str());
+            exit(-1);
+        }
+        this->StoreValues(Map + this->DataOffset, 0, N);
+    }
+
+    munmap((void *) Map, FileSize);
+
+    this->CompressLabels();
+}
+}
@@ -0,0 +1,82 @@
+#ifndef NRRDREADER_H
+#define NRRDREADER_H
+
+#include <string>
+
+#include "Importer.h"
+#include "MiscFunctions.h"
+
+namespace voxel2tet
+{
+
+/**
+ * @brief The NRRDReader class reads three dimensional integer volumes in NRRD format (http://teem.sourceforge.net/nrrd/),
+ * either with the data attached (.nrrd) or in a separate file referred to by the header (.nhdr + .raw). Raw data is
+ * memory mapped. Gzip compressed data is decompressed in large blocks, on a separate thread when more than one thread is
+ * available, while the previous block is converted to material IDs.
+ *
+ * Only the region given by the cut-out is kept in memory.
+ */
+class NRRDReader : public Importer
+{
+private:
+    /**
+     * @brief Number of bytes per value
+     */
+    size_t ScalarSize;
+
+    /**
+     * @brief Tells if values are signed
+     */
+    bool ScalarSigned;
+
+    /**
+     * @brief Tells if multibyte values are stored in big-endian byte order
+     */
+    bool BigEndian;
+
+    /**
+     * @brief Tells if the data is gzip compressed
+     */
+    bool Compressed;
+
+    /**
+     * @brief Name of file containing the data. Equals the header file if the data is attached.
+     */
+    std::string DataFileName;
+
+    /**
+     * @brief Byte offset of the data in DataFileName (when uncompressed) or of the compressed stream
+     */
+    size_t DataOffset;
+
+    /**
+     * @brief Parses the header of an NRRD file and sets up the members describing the data
+     * @param FileName
+     */
+    void ParseHeader(std::string FileName);
+
+    /**
+     * @brief Converts Count consecutive values, starting at linear index First in the complete voxel data, and stores those
+     * inside the loaded region in GrainIdsData.
+     * @param Bytes Raw bytes of the values
+     * @param First Linear index of first value
+     * @param Count Number of values
+     */
+    void StoreValues(const unsigned char *Bytes, size_t First, size_t Count);
+
+    /**
+     * @brief Reads gzip compressed data from a memory mapped file
+     * @param Source Compressed stream
+     * @param SourceSize Number of bytes in Source
+     */
+    void LoadCompressed(const unsigned char *Source, size_t SourceSize);
+
+public:
+    NRRDReader();
+
+    void LoadFile(std::string FileName);
+};
+}
+
+#endif // NRRDREADER_H
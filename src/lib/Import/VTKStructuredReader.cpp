@@ -1,7 +1,35 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <charconv>
+#include <cctype>
+
+#include "Parallel.h"
+
 #include "VTKStructuredReader.h"
 
 namespace voxel2tet
 {
+
+/**
+ * @brief Converts N big-endian integers of type T to material IDs. Values are assembled byte by byte, which is independent
+ * of the endianness of the host and lets the compiler vectorize the loop.
+ */
+template <typename T>
+static void ConvertBigEndian(const unsigned char *Source, int *Destination, size_t N)
+{
+    const size_t s = sizeof(T);
+    for (size_t i = 0; i < N; i++) {
+        uint32_t Value = 0;
+        for (size_t j = 0; j < s; j++) {
+            Value = (Value << 8) | Source[i * s + j];
+        }
+        Destination[i] = (int) (T) Value;
+    }
+}
+
 VTKStructuredReader::VTKStructuredReader()
 {}
 
@@ -26,8 +54,12 @@ void VTKStructuredReader::LoadFile(std::string FileName)
             } else if (linecount == 1) {
                 this->Title = line;
             } else if (linecount == 2) {
-                if (strcasecmp(line.c_str(), "ASCII") != 0) {
-                    STATUS("Can only open VTK ASCII file right now\n", 0);
+                if (strcasecmp(SplitString(line, ' ')[0].c_str(), "BINARY") == 0) {
+                    Input.close();
+                    this->LoadBinaryFile(FileName);
+                    return;
+                } else if (strcasecmp(line.c_str(), "ASCII") != 0) {
+                    STATUS("Can only open VTK ASCII or BINARY files\n", 0);
                 }
             } else {
                 std::vector<std::string> Strings = SplitString(line, ' ');
@@ -57,32 +89,17 @@ void VTKStructuredReader::LoadFile(std::string FileName)
                         }
                     } else if (strcasecmp(Strings[0].c_str(), "CELL_DATA") == 0) {
                         IsCellData = true;
-                        this->celldata = std::stoi(Strings[1]);
+                        this->celldata = std::stoull(Strings[1]);
                         this->GrainIdsData = (int *) malloc(sizeof(int) * this->celldata);
                     } else if (strcasecmp(Strings[0].c_str(), "POINT_DATA") == 0) {
                         IsCellData = false;
-                        this->celldata = std::stoi(Strings[1]);
+                        this->celldata = std::stoull(Strings[1]);
                         this->GrainIdsData = (int *) malloc(sizeof(int) * this->celldata);
                     } else if (strcasecmp(Strings[0].c_str(), "SCALARS") == 0) {
                         this->DataName = Strings[1];
                     } else if (strcasecmp(Strings[0].c_str(), "LOOKUP_TABLE") == 0) {
                         this->TableName = Strings[1];
-                        int scount = 0;
-                        while (true) {
-                            std::getline(Input, line);
-                            std::vector<std::string> TableValues = SplitString(line, ' ');
-                            for (std::string s : TableValues) {
-                                if (s.length() > 0) {
-                                    int Value = std::stoi(s);
-                                    this->GrainIdsData[scount] = Value;
-                                    //printf("%u: %u\n", scount, Value);
-                                    scount++;
-                                }
-                            }
-                            if (scount == this->celldata) {
-                                break;
-                            }
-                        }
+                        this->ParseASCIIData(Input);
                     } else {
                         STATUS("Token %s not recognized\n", Strings[0].c_str());
                     }
@@ -92,6 +109,255 @@ void VTKStructuredReader::LoadFile(std::string FileName)
         }
     }
 
+    this->FinalizeLoad();
+}
+
+/**
+ * @brief Parses whitespace separated integers in [Begin, End) into Values. Stops at the first token which is not an
+ * integer, or after MaxValues values, and returns a pointer to where parsing stopped.
+ */
+static const char *ParseIntegers(const char *Begin, const char *End, std::vector<int> &Values, size_t MaxValues)
+{
+    const char *p = Begin;
+    while (Values.size() < MaxValues) {
+        while ((p < End) && isspace((unsigned char) *p)) {
+            p++;
+        }
+        if (p == End) {
+            break;
+        }
+        int Value;
+        std::from_chars_result r = std::from_chars(p, End, Value);
+        if ((r.ec != std::errc()) || ((r.ptr < End) && !isspace((unsigned char) *r.ptr))) {
+            break;
+        }
+        Values.push_back(Value);
+        p = r.ptr;
+    }
+    return p;
+}
+
+void VTKStructuredReader::ParseASCIIData(std::ifstream &Input)
+{
+    size_t N = this->celldata;
+    size_t scount = 0;
+    unsigned int NumberOfChunks = GiveNumberOfThreads();
+
+    std::vector<char> Block;
+    size_t Carry = 0;
+    std::streamoff BlockStart = Input.tellg();
+
+    // Use blocks of 64 MB, or smaller if the file is smaller
+    Input.seekg(0, std::ios::end);
+    std::streamoff FileSize = Input.tellg();
+    Input.seekg(BlockStart);
+    const size_t BlockSize = std::min((std::streamoff) 64 * 1024 * 1024, FileSize - BlockStart + 1);
+
+    while (scount < N) {
+        // Read next block after the carried over (incomplete) token
+        Block.resize(Carry + BlockSize);
+        Input.read(Block.data() + Carry, BlockSize);
+        size_t Length = Carry + Input.gcount();
+        bool LastBlock = Input.eof() || (Input.gcount() == 0);
+
+        // Only parse complete tokens unless this is the end of the file
+        size_t End = Length;
+        if (!LastBlock) {
+            while ((End > 0) && !isspace((unsigned char) Block[End - 1])) {
+                End--;
+            }
+        }
+
+        // Split block into chunks at whitespace boundaries
+        std::vector<const char *> Bounds(NumberOfChunks + 1);
+        Bounds[0] = Block.data();
+        Bounds[NumberOfChunks] = Block.data() + End;
+        for (unsigned int c = 1; c < NumberOfChunks; c++) {
+            const char *b = std::max(Bounds[c - 1], (const char *) Block.data() + (End * c) / NumberOfChunks);
+            while ((b < Bounds[NumberOfChunks]) && !isspace((unsigned char) *b)) {
+                b++;
+            }
+            Bounds[c] = b;
+        }
+
+        std::vector<std::vector<int>> Values(NumberOfChunks);
+        std::vector<const char *> Stops(NumberOfChunks);
+        size_t Remaining = N - scount;
+        ParallelForRanges(0, NumberOfChunks, [&](unsigned int ThreadID, size_t First, size_t Last) {
+            for (size_t c = First; c < Last; c++) {
+                Stops[c] = ParseIntegers(Bounds[c], Bounds[c + 1], Values[c], Remaining);
+            }
+        });
+
+        // Merge chunks in order
+        for (unsigned int c = 0; (c < NumberOfChunks) && (scount < N); c++) {
+            size_t Count = std::min(Values[c].size(), N - scount);
+            std::copy(Values[c].begin(), Values[c].begin() + Count, this->GrainIdsData + scount);
+            scount += Count;
+
+            bool Complete = (scount == N);
+            bool Stopped = (Stops[c] != Bounds[c + 1]) && (Values[c].size() < Remaining);
+            if (Complete || Stopped) {
+                if (!Complete) {
+                    STATUS("Could not parse data after %zu of %zu values\n", scount, N);
+                    exit(-1);
+                }
+                // Find end of last value used and position stream just after it
+                std::vector<int> Dummy;
+                const char *Stop = ParseIntegers(Bounds[c], Bounds[c + 1], Dummy, Count);
+                Input.clear();
+                Input.seekg(BlockStart + (std::streamoff) (Stop - Block.data()) - (std::streamoff) Carry);
+                std::string Rest;
+                std::getline(Input, Rest);
+                return;
+            }
+        }
+
+        if ((scount < N) && LastBlock) {
+            STATUS("Unexpected end of file after %zu of %zu values\n", scount, N);
+            exit(-1);
+        }
+
+        std::copy(Block.begin() + End, Block.begin() + Length, Block.begin());
+        BlockStart = BlockStart + (Length - Carry);
+        Carry = Length - End;
+    }
+}
+
+void VTKStructuredReader::LoadBinaryFile(std::string FileName)
+{
+    LOG("Open binary VTK file %s\n", FileName.c_str());
+
+    int fd = open(FileName.c_str(), O_RDONLY);
+    struct stat FileStat;
+    if ((fd == -1) || (fstat(fd, &FileStat) == -1)) {
+        STATUS("Cound not open input file %s\n", FileName.c_str());
+        exit(-1);
+    }
+
+    size_t FileSize = FileStat.st_size;
+    void *Map = mmap(NULL, FileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (Map == MAP_FAILED) {
+        STATUS("Could not memory map input file %s\n", FileName.c_str());
+        exit(-1);
+    }
+    madvise(Map, FileSize, MADV_SEQUENTIAL);
+
+    const char *Data = (const char *) Map;
+    size_t Position = 0;
+    int linecount = 0;
+    size_t ScalarSize = 0;
+    std::string ScalarType;
+    const unsigned char *Payload = NULL;
+
+    // Parse header line by line until the LOOKUP_TABLE line, after which the binary payload starts
+    while ((Position < FileSize) && (Payload == NULL)) {
+        const char *LineEnd = (const char *) memchr(Data + Position, '\n', FileSize - Position);
+        size_t Length = (LineEnd == NULL) ? FileSize - Position : LineEnd - (Data + Position);
+        std::string line(Data + Position, Length);
+        if ((line.length() > 0) && (line.back() == '\r')) {
+            line.pop_back();
+        }
+        Position = Position + Length + 1;
+
+        if (linecount == 0) {
+            this->VersionInfo = line;
+        } else if (linecount == 1) {
+            this->Title = line;
+        } else if (linecount > 2) {
+            std::vector<std::string> Strings = SplitString(line, ' ');
+            if (Strings.size() > 0) {
+                if (strcasecmp(Strings[0].c_str(), "DATASET") == 0) {
+                    if (strcasecmp(Strings[1].c_str(), "STRUCTURED_POINTS") != 0) {
+                        STATUS("Can only handle VTK files with dataset STRUCTURED_POINTS\n", 0);
+                        exit(-1);
+                    }
+                } else if (strcasecmp(Strings[0].c_str(), "DIMENSIONS") == 0) {
+                    this->dimensions_data[0] = std::stoi(Strings[1]) - 1;
+                    this->dimensions_data[1] = std::stoi(Strings[2]) - 1;
+                    this->dimensions_data[2] = std::stoi(Strings[3]) - 1;
+                } else if (strcasecmp(Strings[0].c_str(), "ORIGIN") == 0) {
+                    for (int i = 0; i < 3; i++) {
+                        this->origin_data[i] = std::stof(Strings[i + 1]);
+                    }
+                } else if ((strcasecmp(Strings[0].c_str(), "SPACING") == 0) ||
+                           (strcasecmp(Strings[0].c_str(), "ASPECT_RATIO") == 0)) {
+                    for (int i = 0; i < 3; i++) {
+                        this->spacing_data[i] = std::stof(Strings[i + 1]);
+                    }
+                } else if (strcasecmp(Strings[0].c_str(), "CELL_DATA") == 0) {
+                    IsCellData = true;
+                    this->celldata = std::stoull(Strings[1]);
+                } else if (strcasecmp(Strings[0].c_str(), "POINT_DATA") == 0) {
+                    IsCellData = false;
+                    this->celldata = std::stoull(Strings[1]);
+                } else if (strcasecmp(Strings[0].c_str(), "SCALARS") == 0) {
+                    this->DataName = Strings[1];
+                    ScalarType = Strings[2];
+                    if ((Strings.size() > 3) && (std::stoi(Strings[3]) != 1)) {
+                        STATUS("Can only handle scalars with one component\n", 0);
+                        exit(-1);
+                    }
+                    if ((ScalarType == "char") || (ScalarType == "unsigned_char")) {
+                        ScalarSize = 1;
+                    } else if ((ScalarType == "short") || (ScalarType == "unsigned_short")) {
+                        ScalarSize = 2;
+                    } else if ((ScalarType == "int") || (ScalarType == "unsigned_int")) {
+                        ScalarSize = 4;
+                    } else {
+                        STATUS("Scalar type %s not supported in binary VTK files\n", ScalarType.c_str());
+                        exit(-1);
+                    }
+                } else if (strcasecmp(Strings[0].c_str(), "LOOKUP_TABLE") == 0) {
+                    this->TableName = Strings[1];
+                    Payload = (const unsigned char *) Data + Position;
+                } else {
+                    STATUS("Token %s not recognized\n", Strings[0].c_str());
+                }
+            }
+        }
+        linecount++;
+    }
+
+    if ((Payload == NULL) || (ScalarSize == 0)) {
+        STATUS("No scalar data found in %s\n", FileName.c_str());
+        exit(-1);
+    }
+
+    size_t N = this->celldata;
+    if (Position + N * ScalarSize > FileSize) {
+        STATUS("File %s is truncated\n", FileName.c_str());
+        exit(-1);
+    }
+
+    this->GrainIdsData = (int *) malloc(sizeof(int) * N);
+    if (ScalarType == "char") {
+        ConvertBigEndian<int8_t>(Payload, this->GrainIdsData, N);
+    } else if (ScalarType == "unsigned_char") {
+        ConvertBigEndian<uint8_t>(Payload, this->GrainIdsData, N);
+    } else if (ScalarType == "short") {
+        ConvertBigEndian<int16_t>(Payload, this->GrainIdsData, N);
+    } else if (ScalarType == "unsigned_short") {
+        ConvertBigEndian<uint16_t>(Payload, this->GrainIdsData, N);
+    } else if (ScalarType == "int") {
+        ConvertBigEndian<int32_t>(Payload, this->GrainIdsData, N);
+    } else {
+        ConvertBigEndian<uint32_t>(Payload, this->GrainIdsData, N);
+    }
+
+    munmap(Map, FileSize);
+
+    for (int i = 0; i < 3; i++) {
+        this->BoundingBox.minvalues[i] = this->origin_data[i];
+        this->BoundingBox.maxvalues[i] = this->origin_data[i] + this->dimensions_data[i] * this->spacing_data[i];
+    }
+
+    this->FinalizeLoad();
+}
+
+void VTKStructuredReader::FinalizeLoad()
+{
     // If we are given points, move origin, change dimensions and recalculate boundingbox
     if (!IsCellData) {
         for (int i=0; i<3; i++) {
@@ -102,5 +368,13 @@ void VTKStructuredReader::LoadFile(std::string FileName)
         }
     }
 
+    // The complete voxel data is held in memory, but only the cut-out is kept by CompressLabels
+    this->CheckCutOut();
+    for (int i=0; i<3; i++) {
+        this->offset_loaded[i] = 0;
+        this->dimensions_loaded[i] = this->dimensions_data[i];
+    }
+
+    this->CompressLabels();
 }
 }
@@ -12,7 +12,7 @@ namespace voxel2tet
 {
 
 /**
- * @brief The VTKStructuredReader class read data from a structure VTK ASCII file.
+ * @brief The VTKStructuredReader class read data from a structure VTK file in ASCII or BINARY format.
  */
 class VTKStructuredReader : public Importer
 {
@@ -21,8 +21,27 @@ private:
     std::string Title;
     std::string DataName;
     std::string TableName;
-    int celldata;
+    size_t celldata;
     bool IsCellData;
+
+    /**
+     * @brief Loads a legacy VTK file in BINARY format. The file is memory mapped and the big-endian scalars are converted
+     * to material IDs in one pass. Handles 8-, 16- and 32-bit integer scalars.
+     * @param FileName
+     */
+    void LoadBinaryFile(std::string FileName);
+
+    /**
+     * @brief Parses celldata ASCII integers from the current position of Input into GrainIdsData. The data is read in large
+     * blocks which are split at whitespace and parsed in parallel. On return, Input is positioned just after the last value.
+     * @param Input Input stream positioned at the start of the data section
+     */
+    void ParseASCIIData(std::ifstream &Input);
+
+    /**
+     * @brief Updates origin, dimensions and bounding box when the data is given as point data
+     */
+    void FinalizeLoad();
 public:
     VTKStructuredReader();
 
@@ -7,38 +7,17 @@ namespace voxel2tet
 {
 // VertexType
 
-VertexType::VertexType(double x, double y, double z)
+VertexType::VertexType(MeshTopology *Topology, double x, double y, double z)
 {
-    this->c[0] = x;
-    this->c[1] = y;
-    this->c[2] = z;
+    this->Topology = Topology;
+    this->TopologyIndex = Topology->AddVertex(x, y, z);
     this->originalcoordinates[0] = x;
     this->originalcoordinates[1] = y;
     this->originalcoordinates[2] = z;
     this->Fixed = {{false, false, false}};
     this->c_constant = 0.0;
     this->error = 0.0;
-}
-
-void VertexType::set_c(std::array<double, 3> newc)
-{
-    this->c = newc;
-    for (TriangleType *t : this->Triangles) {
-        t->UpdateNormal();
-    }
-}
-
-void VertexType::set_c(double c, int index)
-{
-    this->c[index] = c;
-    for (TriangleType *t : this->Triangles) {
-        t->UpdateNormal();
-    }
-}
-
-std::array<double, 3> VertexType::get_c()
-{
-    return this->c;
+    this->PositionVersion = 0;
 }
 
 arma::vec VertexType::get_c_vec()
@@ -47,11 +26,6 @@ arma::vec VertexType::get_c_vec()
     return c;
 }
 
-double VertexType::get_c(int index)
-{
-    return this->c[index];
-}
-
 void VertexType::AddPhaseEdge(PhaseEdge *pe)
 {
     this->PhaseEdges.push_back(pe);
@@ -59,41 +33,11 @@ void VertexType::AddPhaseEdge(PhaseEdge *pe)
     this->PhaseEdges.erase(std::unique(this->PhaseEdges.begin(), this->PhaseEdges.end()), this->PhaseEdges.end());
 }
 
-void VertexType::AddTriangle(TriangleType *Triangle)
-{
-    for (TriangleType *T : this->Triangles) {
-        if (T == Triangle) {
-            return;
-        }
-    }
-    this->Triangles.push_back(Triangle);
-}
-
-void VertexType::RemoveTriangle(TriangleType *Triangle)
-{
-    this->Triangles.erase(std::remove(this->Triangles.begin(), this->Triangles.end(), Triangle), this->Triangles.end());
-}
-
-void VertexType::AddEdge(EdgeType *Edge)
-{
-    for (EdgeType *E : this->Edges) {
-        if (E == Edge) {
-            return;
-        }
-    }
-    this->Edges.push_back(Edge);
-}
-
-void VertexType::RemoveEdge(EdgeType *Edge)
-{
-    this->Edges.erase(std::remove(this->Edges.begin(), this->Edges.end(), Edge), this->Edges.end());
-}
-
 std::vector<VertexType *> VertexType::FetchNeighbouringVertices()
 {
     std::vector<VertexType *> Neighbours;
 
-    for (auto e : this->Edges) {
+    for (auto e : this->GiveEdges()) {
         for (auto v : e->Vertices) {
             if (v != this) {
                 Neighbours.push_back(v);
@@ -107,18 +51,9 @@ std::vector<VertexType *> VertexType::FetchNeighbouringVertices()
 
 std::vector<TriangleType *> EdgeType::GiveTriangles()
 {
-    std::vector<TriangleType *> TriangleCollection;
-
-    for (int i : {0, 1}) {
-        std::sort(this->Vertices[i]->Triangles.begin(), this->Vertices[i]->Triangles.end());
-    }
-
-    std::set_intersection(this->Vertices[0]->Triangles.begin(), this->Vertices[0]->Triangles.end(),
-                          this->Vertices[1]->Triangles.begin(), this->Vertices[1]->Triangles.end(),
-                          std::back_inserter(TriangleCollection));
-
+    TopologyCycle<TriangleType, 3> Triangles = this->Vertices[0]->Topology->GiveEdgeTriangles(this->TopologyIndex);
+    std::vector<TriangleType *> TriangleCollection(Triangles.begin(), Triangles.end());
     std::sort(TriangleCollection.begin(), TriangleCollection.end(), SortByID<TriangleType *>);
-
     return TriangleCollection;
 }
 
@@ -147,7 +82,26 @@ std::array<double, 3> EdgeType::GiveCenterPoint()
 TriangleType::TriangleType(std::array<VertexType *, 3> Vertices)
 {
     this->Vertices = Vertices;
-    this->UpdateNormal();
+    this->Edges = {{NULL, NULL, NULL}};
+    this->CachedVertices = {{NULL, NULL, NULL}};
+    this->CachedQuantities = 0;
+    this->TopologyIndex = NoTopologyIndex;
+}
+
+bool TriangleType::IsCached(CachedQuantity Quantity)
+{
+    for (int i = 0; i < 3; i++) {
+        if ((this->CachedVertices[i] != this->Vertices[i]) ||
+            (this->CachedVersions[i] != this->Vertices[i]->GivePositionVersion())) {
+            for (int j = 0; j < 3; j++) {
+                this->CachedVertices[j] = this->Vertices[j];
+                this->CachedVersions[j] = this->Vertices[j]->GivePositionVersion();
+            }
+            this->CachedQuantities = 0;
+            return false;
+        }
+    }
+    return (this->CachedQuantities & Quantity) != 0;
 }
 
 std::array<double, 3> TriangleType::GiveEdgeVector(int node)
@@ -163,19 +117,48 @@ std::array<double, 3> TriangleType::GiveEdgeVector(int node)
     return edgevector;
 }
 
+std::array<double, 3> TriangleType::GiveNormal()
+{
+    if (this->IsCached(CQ_NORMAL)) {
+        return this->Normal;
+    }
+
+    std::array<double, 3> edge0 = this->GiveEdgeVector(0);
+    std::array<double, 3> edge1 = this->GiveEdgeVector(1);
+
+    this->Normal[0] = edge0[1] * edge1[2] - edge1[1] * edge0[2];
+    this->Normal[1] = -edge0[0] * edge1[2] + edge1[0] * edge0[2];
+    this->Normal[2] = edge0[0] * edge1[1] - edge1[0] * edge0[1];
+
+    this->CachedQuantities |= CQ_NORMAL;
+    return this->Normal;
+}
+
 std::array<double, 3> TriangleType::GiveUnitNormal()
 {
-    double l = std::sqrt(
-            this->Normal[0] * this->Normal[0] + this->Normal[1] * this->Normal[1] + this->Normal[2] * this->Normal[2]);
+    if (this->IsCached(CQ_UNITNORMAL)) {
+        return this->UnitNormal;
+    }
+
     std::array<double, 3> NormalizedNormal = this->GiveNormal();
+    double l = std::sqrt(
+            NormalizedNormal[0] * NormalizedNormal[0] + NormalizedNormal[1] * NormalizedNormal[1] +
+            NormalizedNormal[2] * NormalizedNormal[2]);
     for (int i = 0; i < 3; i++) {
         NormalizedNormal[i] = NormalizedNormal[i] / l;
     }
-    return NormalizedNormal;
+
+    this->UnitNormal = NormalizedNormal;
+    this->CachedQuantities |= CQ_UNITNORMAL;
+    return this->UnitNormal;
 }
 
 double TriangleType::GiveArea() // TODO: Should call GiveSignedArea
 {
+    if (this->IsCached(CQ_AREA)) {
+        return this->Area;
+    }
+
     double e1[3], e2[3], n[3];
 
     // Compute two vectors with origin in vertex 0 describing the triangle
@@ -190,8 +173,9 @@ double TriangleType::GiveArea() // TODO: Should call GiveSignedArea
     n[2] = e1[0] * e2[1] - e2[0] * e1[1];
 
     // Compute area
-    double Area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) / 2.0;
-    return Area;
+    this->Area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) / 2.0;
+    this->CachedQuantities |= CQ_AREA;
+    return this->Area;
 }
 
 double TriangleType::GiveSignedArea()
@@ -217,17 +201,31 @@ double TriangleType::GiveSignedArea()
 
 std::array<double, 3> TriangleType::GiveCenterOfMass()
 {
+    if (this->IsCached(CQ_CENTEROFMASS)) {
+        return this->CenterOfMass;
+    }
+
     std::array<double, 3> cm = {{0, 0, 0}};
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
             cm[i] = cm[i] + this->Vertices[j]->get_c(i) / 3;
         }
     }
-    return cm;
+
+    this->CenterOfMass = cm;
+    this->CachedQuantities |= CQ_CENTEROFMASS;
+    return this->CenterOfMass;
 }
 
 double TriangleType::GiveLargestAngle(int *index)
 {
+    if (this->IsCached(CQ_LARGESTANGLE)) {
+        if (index != NULL) {
+            *index = this->LargestAngleIndex;
+        }
+        return this->LargestAngle;
+    }
+
     std::array<std::array<double, 3>, 3> e;
     std::array<double, 3> length;
     std::array<double, 3> alpha;
@@ -237,7 +235,8 @@ double TriangleType::GiveLargestAngle(int *index)
         length[i] = std::sqrt(e[i][0] * e[i][0] + e[i][1] * e[i][1] + e[i][2] * e[i][2]);
     }
 
-    double LargestAngle = -1.0;
+    this->LargestAngle = -1.0;
+    this->LargestAngleIndex = -1;
 
     for (int node = 0; node < 3; node++) {
         int prevnode = (node > 0) ? (node - 1) : (2);
@@ -245,19 +244,28 @@ double TriangleType::GiveLargestAngle(int *index)
         alpha[node] = std::acos(
                 -(e[node][0] * e[prevnode][0] + e[node][1] * e[prevnode][1] + e[node][2] * e[prevnode][2]) /
                 (length[node] * length[prevnode]));
-        if (alpha[node] > LargestAngle) {
-            LargestAngle = alpha[node];
-            if (index != NULL) {
-                *index = node;
-            }
+        if (alpha[node] > this->LargestAngle) {
+            this->LargestAngle = alpha[node];
+            this->LargestAngleIndex = node;
         }
     }
 
-    return LargestAngle;
+    if (index != NULL) {
+        *index = this->LargestAngleIndex;
+    }
+    this->CachedQuantities |= CQ_LARGESTANGLE;
+    return this->LargestAngle;
 }
 
 double TriangleType::GiveSmallestAngle(int *index)
 {
+    if (this->IsCached(CQ_SMALLESTANGLE)) {
+        if (index != NULL) {
+            *index = this->SmallestAngleIndex;
+        }
+        return this->SmallestAngle;
+    }
+
     std::array<std::array<double, 3>, 3> e;
     std::array<double, 3> length;
     std::array<double, 3> alpha;
@@ -267,7 +275,8 @@ double TriangleType::GiveSmallestAngle(int *index)
         length[i] = std::sqrt(e[i][0] * e[i][0] + e[i][1] * e[i][1] + e[i][2] * e[i][2]);
     }
 
-    double SmallestAngle = 100.0;
+    this->SmallestAngle = 100.0;
+    this->SmallestAngleIndex = -1;
 
     for (int node = 0; node < 3; node++) {
         int prevnode = (node > 0) ? (node - 1) : (2);
@@ -275,15 +284,17 @@ double TriangleType::GiveSmallestAngle(int *index)
         alpha[node] = std::acos(
                 -(e[node][0] * e[prevnode][0] + e[node][1] * e[prevnode][1] + e[node][2] * e[prevnode][2]) /
                 (length[node] * length[prevnode]));
-        if (alpha[node] < SmallestAngle) {
-            SmallestAngle = alpha[node];
-            if (index != NULL) {
-                *index = node;
-            }
+        if (alpha[node] < this->SmallestAngle) {
+            this->SmallestAngle = alpha[node];
+            this->SmallestAngleIndex = node;
         }
     }
 
-    return SmallestAngle;
+    if (index != NULL) {
+        *index = this->SmallestAngleIndex;
+    }
+    this->CachedQuantities |= CQ_SMALLESTANGLE;
+    return this->SmallestAngle;
 }
 
 EdgeType *TriangleType::GiveEdge(int Index)
@@ -294,35 +305,17 @@ EdgeType *TriangleType::GiveEdge(int Index)
 
 std::array<EdgeType *, 3> TriangleType::GiveEdges()
 {
-    std::vector<EdgeType *> EdgeCollection;
-
-    for (int i = 0; i < 3; i++) {
-        EdgeCollection.insert(EdgeCollection.end(), this->Vertices[i]->Edges.begin(), this->Vertices[i]->Edges.end());
-    }
-
-    // Sort and check if neighbours in vector are copies. If so, we have found an edge of the triangle.
-    std::sort(EdgeCollection.begin(), EdgeCollection.end(), SortByID<EdgeType *>);
-    std::array<EdgeType *, 3> DupEdges;
-    int i = 0;
-    size_t j = 0;
-    while (j < EdgeCollection.size()) {
-        if ((j + 1) == EdgeCollection.size()) {
-            break;
-        }
-        if (EdgeCollection.at(j + 1) == EdgeCollection.at(j)) {
-            DupEdges.at(i) = EdgeCollection.at(j);
-            i++;
-            j++;
-        }
-        j++;
-    }
-
-    return DupEdges;
-
+    std::array<EdgeType *, 3> SortedEdges = this->Edges;
+    std::sort(SortedEdges.begin(), SortedEdges.end(), SortByID<EdgeType *>);
+    return SortedEdges;
 }
 
 double TriangleType::GiveLongestEdgeLength()
 {
+    if (this->IsCached(CQ_LONGESTEDGELENGTH)) {
+        return this->LongestEdgeLength;
+    }
+
     double l = 0.0;
     for (int i = 0; i < 3; i++) {
         int nexti = (i == 2) ? 0 : i + 1;
@@ -334,17 +327,10 @@ double TriangleType::GiveLongestEdgeLength()
             l = alpha;
         }
     }
-    return l;
-}
-
-void TriangleType::UpdateNormal()
-{
-    std::array<double, 3> edge0 = this->GiveEdgeVector(0);
-    std::array<double, 3> edge1 = this->GiveEdgeVector(1);
 
-    this->Normal[0] = edge0[1] * edge1[2] - edge1[1] * edge0[2];
-    this->Normal[1] = -edge0[0] * edge1[2] + edge1[0] * edge0[2];
-    this->Normal[2] = edge0[0] * edge1[1] - edge1[0] * edge0[1];
+    this->LongestEdgeLength = l;
+    this->CachedQuantities |= CQ_LONGESTEDGELENGTH;
+    return this->LongestEdgeLength;
 }
 
 void TriangleType::FlipNormal()
@@ -353,11 +339,18 @@ void TriangleType::FlipNormal()
     this->Vertices[0] = this->Vertices[1];
     this->Vertices[1] = v;
 
+    // Edge 0 still connects vertices 0 and 1 while edges 1 and 2 trade places
+    EdgeType *e = this->Edges[1];
+    this->Edges[1] = this->Edges[2];
+    this->Edges[2] = e;
+
+    if (this->TopologyIndex != NoTopologyIndex) {
+        this->Vertices[0]->Topology->FlipTriangle(this->TopologyIndex);
+    }
+
     int PosPhase = this->PosNormalMatID;
     this->PosNormalMatID = this->NegNormalMatID;
     this->NegNormalMatID = PosPhase;
-
-    this->UpdateNormal();
 }
 
 // TetType
@@ -3,12 +3,28 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
 #define ARMA_USE_CXX11
 #include <armadillo>
 #include "math.h"
 
+#include "MeshTopology.h"
+
 namespace voxel2tet
 {
+
+#ifndef VOXEL2TET_ID_TYPE
+#define VOXEL2TET_ID_TYPE int64_t
+#endif
+
+/**
+ * @brief Signed integer type of the IDs of vertices, edges, triangles and tetrahedrons. Defaults to 64 bits since the
+ * number of mesh entities may exceed 2^31 for large volumes. Can be changed by defining VOXEL2TET_ID_TYPE. Note that the
+ * number of vertices, edges and triangles of a mesh is also limited by TopologyIndexType, which by default
+ * allows about 1.4e9 of each.
+ */
+typedef VOXEL2TET_ID_TYPE IDType;
+
 class TriangleType;
 
 class EdgeType;
@@ -18,17 +34,27 @@ class PhaseEdge;
 /**
  * @brief The VertexType class provides information relevant to one vertex in the mesh.
  *
- * The VertexType object knows which triangles and edges it is connected to. The TriangleType
- * and EdgeType objects however, does only know which vertices they are connected to. In order
- * for a triangle to access the connected edges, it har to ask its vertices. The same goes for
- * the edges looking for connected triangles.
+ * The coordinates of the vertex and the triangles and edges it is connected to are held by the MeshTopology of the mesh.
  */
 class VertexType
 {
 private:
-    std::array<double, 3> c;
+    /**
+     * @brief Incremented each time the coordinates change. Used by TriangleType to tell if its cached geometry is valid.
+     */
+    unsigned int PositionVersion;
 
 public:
+    /**
+     * @brief Topology holding the coordinates and the connectivity of the vertex
+     */
+    MeshTopology *Topology;
+
+    /**
+     * @brief Index of the vertex in Topology
+     */
+    TopologyIndexType TopologyIndex;
+
     /**
      * @brief Specifies the value of the 'c' constant in the non-linear spring
      */
@@ -42,7 +68,7 @@ public:
     /**
      * @brief ID of current vertex. Mainly for debugging purposes.
      */
-    int ID;
+    IDType ID;
 
     /**
      * @brief Arbitrary tag on vertex.
@@ -83,12 +109,13 @@ public:
     { return PhaseEdges.size() > 0; }
 
     /**
-     * @brief Constructor
+     * @brief Constructor. Adds the vertex to a topology.
+     * @param Topology Topology of the mesh
      * @param x X coordinate
      * @param y Y coodrinate
      * @param z Z coordinate
      */
-    VertexType(double x, double y, double z);
+    VertexType(MeshTopology *Topology, double x, double y, double z);
 
     /**
      * @brief Contains the original coordinates before smoothing.
@@ -99,27 +126,42 @@ public:
      * @brief Update coordinates of this vertex
      * @param newc Array containing new coordinate information
      */
-    void set_c(std::array<double, 3> newc);
+    void set_c(std::array<double, 3> newc)
+    {
+        for (int i = 0; i < 3; i++) {
+            this->Topology->Coordinates[i][this->TopologyIndex] = newc[i];
+        }
+        this->PositionVersion++;
+    }
 
     /**
      * @brief Update coordinates of this vertex
      * @param c Coordinate value
      * @param index Index of coordinate, 0 is X, 1 is Y and 2 is Z.
      */
-    void set_c(double c, int index);
+    void set_c(double c, int index)
+    {
+        this->Topology->Coordinates[index][this->TopologyIndex] = c;
+        this->PositionVersion++;
+    }
 
     /**
      * @brief Retrieve coordinates of current vertex
      * @return Coordinates
      */
-    std::array<double, 3> get_c();
+    std::array<double, 3> get_c()
+    {
+        return {{this->Topology->Coordinates[0][this->TopologyIndex], this->Topology->Coordinates[1][this->TopologyIndex],
+                 this->Topology->Coordinates[2][this->TopologyIndex]}};
+    }
 
     /**
      * @brief Retrieve coordinate by index
      * @param index Index of coordinate. 0 is X, 1 is Y and 2 is Z.
      * @return Coordinate value
      */
-    double get_c(int index);
+    double get_c(int index)
+    { return this->Topology->Coordinates[index][this->TopologyIndex]; }
 
     /**
      * Gives coordinate as arma::vec
@@ -128,38 +170,27 @@ public:
     arma::vec get_c_vec();
 
     /**
-     * @brief List of triangles connected to this vertex
-     */
-    std::vector<TriangleType *> Triangles;
-
-    /**
-     * @brief List of edges connected to this vertex
-     */
-    std::vector<EdgeType *> Edges;
-
-    /**
-     * @brief Adds a triangle to vertex triangle list and ensures uniqueness on list
-     * @param Triangle Pointer to triangle to add
-     */
-    void AddTriangle(TriangleType *Triangle);
-
-    /**
-     * @brief Removes triangle from list. Note, no memory is freed.
-     * @param Triangle Pointer to triangle to remove
+     * @brief Gives the position version, which changes each time the coordinates of the vertex are updated
+     * @return Position version
      */
-    void RemoveTriangle(TriangleType *Triangle);
+    unsigned int GivePositionVersion()
+    { return this->PositionVersion; }
 
     /**
-     * @brief Adds an edge to vertex edge list and ensures uniqueness on list
-     * @param Edge Pointer to edge to add
+     * @brief Gives the triangles connected to this vertex, in the order they were added to the mesh. The range is
+     * invalidated when triangles are added to or removed from the vertex.
+     * @return Range of triangles
      */
-    void AddEdge(EdgeType *Edge);
+    TopologyCycle<TriangleType, 3> GiveTriangles()
+    { return this->Topology->GiveVertexTriangles(this->TopologyIndex); }
 
     /**
-     * @brief Removes an edge from edge list
-     * @param Edge Edge to be removed. Note, no memory is freed
+     * @brief Gives the edges connected to this vertex, in the order they were connected. The range is invalidated when
+     * edges are added to or removed from the vertex.
+     * @return Range of edges
      */
-    void RemoveEdge(EdgeType *Edge);
+    TopologyCycle<EdgeType, 2> GiveEdges()
+    { return this->Topology->GiveVertexEdges(this->TopologyIndex); }
 
     /**
      * @brief Produce a list of all neighbouring vertices
@@ -175,13 +206,25 @@ public:
  * Here, an edge referres to an edge of a triangle which can be shared among several triangles. An edge is
  * defined by it's two end points.
  *
- * The Edge object knows which two vertices it is defined by. It does not, however, know which triangles are
- * connected. For that information it relies on the vertices, which in turn, knows.
+ * The Edge object knows which two vertices it is defined by. The triangles it is part of are held by the MeshTopology of
+ * the mesh, and may be any number.
  *
  */
 class EdgeType
 {
 public:
+    /**
+     * @brief Constructor
+     */
+    EdgeType()
+    {
+        this->IsTransverse = false;
+        this->ID = 0;
+        this->SlotIndex = 0;
+        this->Vertices = {{NULL, NULL}};
+        this->TopologyIndex = NoTopologyIndex;
+    }
+
     /**
      * True if the edge is a transverse, i.e. a diagonal of a square. Edges that are transverse should no cound as a spring during smoothing
      */
@@ -190,23 +233,26 @@ public:
     /**
      * @brief ID of edge. Mainly for debugging purposes.
      */
-    int ID;
+    IDType ID;
+
+    /**
+     * @brief Index of the edge in MeshData::Edges
+     */
+    size_t SlotIndex;
 
     /**
      * @brief Array of two vertices describing the edge.
      */
     std::array<VertexType *, 2> Vertices;
 
+    /**
+     * @brief Index of the edge in the MeshTopology of its vertices. NoTopologyIndex if the edge is not in a mesh.
+     */
+    TopologyIndexType TopologyIndex;
+
     /**
      * @brief Produces a list of triangles connected to this edge.
-     *
-     * The triangles connected to this edge is computed as
-     *
-     * \f$ T(V_1) \cap T(V_2) \f$
-     *
-     * where \f$ T(V_\alpha) \f$ is the set of all triangles connected to vertex \f$V_\alpha\f$.
-     *
-     * @return List of triangles
+     * @return List of triangles, sorted by ID
      */
     std::vector<TriangleType *> GiveTriangles();
 
@@ -230,7 +276,7 @@ public:
  * the coordinates are given, we can determine if the normal is pointing inwards or outwards of the surface volume it is
  * part of, by comparing the PosNormalMatID and NegNormalMatID members to the material ID of the volume.
  *
- * The Triangle object does not know which Edge objects it is connected to but relies on its vertices to find out.
+ * The Triangle object knows its Edge objects once it is added to a mesh. They are kept up to date by MeshData.
  */
 class TriangleType
 {
@@ -238,15 +284,61 @@ private:
     // Give vector for edge between node and node+1
     std::array<double, 3> GiveEdgeVector(int node);
 
-    // Normal of element
+    /**
+     * @brief Flags for the quantities held in the geometry cache
+     */
+    enum CachedQuantity
+    {
+        CQ_NORMAL = 1, CQ_UNITNORMAL = 2, CQ_AREA = 4, CQ_CENTEROFMASS = 8, CQ_SMALLESTANGLE = 16,
+        CQ_LARGESTANGLE = 32, CQ_LONGESTEDGELENGTH = 64
+    };
+
+    /**
+     * @brief Vertices for which the cached geometry was computed
+     */
+    std::array<VertexType *, 3> CachedVertices;
+
+    /**
+     * @brief Position versions of CachedVertices when the cached geometry was computed
+     */
+    std::array<unsigned int, 3> CachedVersions;
+
+    /**
+     * @brief Bitwise combination of CachedQuantity flags for the quantities currently in the cache
+     */
+    unsigned int CachedQuantities;
+
+    // Cached geometry
     std::array<double, 3> Normal;
+    std::array<double, 3> UnitNormal;
+    std::array<double, 3> CenterOfMass;
+    double Area;
+    double SmallestAngle;
+    double LargestAngle;
+    double LongestEdgeLength;
+    int SmallestAngleIndex;
+    int LargestAngleIndex;
+
+    /**
+     * @brief Tells if a quantity is in the geometry cache. The cache is emptied if any vertex of the triangle has been
+     * moved or replaced since the cache was filled.
+     * @param Quantity Quantity to look for
+     * @return True if the cached value of the quantity can be used
+     */
+    bool IsCached(CachedQuantity Quantity);
+
 public:
 
     /**
      * @brief Constructor
      */
     TriangleType()
-    {}
+    {
+        this->Edges = {{NULL, NULL, NULL}};
+        this->CachedVertices = {{NULL, NULL, NULL}};
+        this->CachedQuantities = 0;
+        this->TopologyIndex = NoTopologyIndex;
+    }
 
     /**
      * @brief Constructor
@@ -257,7 +349,17 @@ public:
     /**
      * @brief ID of Triangle object. Mostly for debugging purposes.
      */
-    int ID;
+    IDType ID;
+
+    /**
+     * @brief Index of the triangle in MeshData::Triangles
+     */
+    size_t SlotIndex;
+
+    /**
+     * @brief Index of the triangle in the MeshTopology of its vertices. NoTopologyIndex if the triangle is not in a mesh.
+     */
+    TopologyIndexType TopologyIndex;
 
     /**
      * @brief ID of the interface the triangle is part of.
@@ -275,10 +377,17 @@ public:
     int NegNormalMatID;
 
     /**
-     * @brief Array of vertices defining the triangle
+     * @brief Array of vertices defining the triangle. Derived quantities (area, normal, angles etc.) are cached and
+     * recomputed only after a vertex has been moved or replaced.
      */
     std::array<VertexType *, 3> Vertices;
 
+    /**
+     * @brief Edges of the triangle. Edges[i] connects Vertices[i] and Vertices[(i + 1) % 3]. Set by MeshData when the
+     * triangle is added to the mesh, NULL before that.
+     */
+    std::array<EdgeType *, 3> Edges;
+
     /**
      * @brief Returns the Edge object located at edge index
      * @param Index Index of edge to be retrieved
@@ -287,15 +396,8 @@ public:
     EdgeType *GiveEdge(int Index);
 
     /**
-     * @brief Returns array of pointer to Edge objects defining the triangle
-     *
-     * The edges are found as
-     *
-     * \f$ \cap_{i=1}^3 E(V_i) \f$
-     *
-     * where \f$ E(V_i) \f$ are all edges connected to vertex \f$ i \f$ of the triangle.
-     *
-     * @return Array of pointers to Edge objects
+     * @brief Returns array of pointer to Edge objects defining the triangle. Only valid for triangles in a mesh.
+     * @return Array of pointers to Edge objects, sorted by ID
      */
     std::array<EdgeType *, 3> GiveEdges();
 
@@ -338,14 +440,10 @@ public:
     double GiveSmallestAngle(int *index = NULL);
 
     /**
-     * @brief Gives normal of triangle.
-     *
-     * For performance, the normal is not computed every time and requires updating as coordinates or orientation change.
-     *
+     * @brief Gives normal of triangle. The length of the normal is twice the area of the triangle.
      * @return Array of doubles describing the normal
      */
-    std::array<double, 3> GiveNormal()
-    { return Normal; }
+    std::array<double, 3> GiveNormal();
 
     /**
      * @brief Gives normalized normal. See GiveNormal().
@@ -354,12 +452,8 @@ public:
     std::array<double, 3> GiveUnitNormal();
 
     /**
-     * @brief Updates normal
-     */
-    void UpdateNormal();
-
-    /**
-     * @brief Change orientation of triangle by reordering the vertizes. Also updates PosNormalMatID and NegNormalMatID.
+     * @brief Change orientation of triangle by reordering the vertizes. Also updates PosNormalMatID and NegNormalMatID,
+     * and the corners of the triangle in the MeshTopology if the triangle is in a mesh.
      */
     void FlipNormal();
 };
@@ -391,7 +485,7 @@ public:
     /**
      * @brief ID of element. Mostly for debugging purposes.
      */
-    int ID;
+    IDType ID;
 
     /**
      * @brief Material ID
@@ -11,52 +11,135 @@ namespace voxel2tet
 MeshData::MeshData(BoundingBoxType BoundingBox)
 {
     this->BoundingBox = BoundingBox;
-    this->VertexOctreeRoot = new VertexOctreeNode(this->BoundingBox, &this->Vertices, 0);
+    this->VertexOctreeRoot = new VertexOctreeNode(this->BoundingBox, &this->Vertices, &this->VertexPool, &this->Topology,
+                                                  0);
     this->TriangleCounter = 0;
     this->EdgeCounter = 0;
+    this->SweepDepth = 0;
+    this->NumberOfRemovedEdges = 0;
+    this->NumberOfRemovedTriangles = 0;
 }
 
 MeshData::~MeshData()
 {
-    for (unsigned int i = 0; i < this->Edges.size(); i++) {
-        delete this->Edges.at(i);
-    }
-
-    for (auto t : this->Triangles) {
-        delete t;
-    }
-
-    for (auto v : this->Vertices) {
-        delete v;
-    }
-
-    for (auto t : this->Tets) {
-        delete t;
-    }
-
+    // The vertices, edges, triangles and tetrahedrons are freed by their pools
     delete this->VertexOctreeRoot;
 }
 
+void MeshData::WriteAllocationStatistics(std::ostream &Stream)
+{
+    Stream << "Entity\tAllocations\tReused\tAlive\tCapacity\n";
+    Stream << "Vertex\t" << this->VertexPool.GiveNumberOfAllocations() << "\t" << this->VertexPool.GiveNumberOfReuses()
+           << "\t" << this->VertexPool.GiveNumberOfObjects() << "\t" << this->VertexPool.GiveCapacity() << "\n";
+    Stream << "Edge\t" << this->EdgePool.GiveNumberOfAllocations() << "\t" << this->EdgePool.GiveNumberOfReuses()
+           << "\t" << this->EdgePool.GiveNumberOfObjects() << "\t" << this->EdgePool.GiveCapacity() << "\n";
+    Stream << "Triangle\t" << this->TrianglePool.GiveNumberOfAllocations() << "\t"
+           << this->TrianglePool.GiveNumberOfReuses() << "\t" << this->TrianglePool.GiveNumberOfObjects() << "\t"
+           << this->TrianglePool.GiveCapacity() << "\n";
+    Stream << "Tet\t" << this->TetPool.GiveNumberOfAllocations() << "\t" << this->TetPool.GiveNumberOfReuses() << "\t"
+           << this->TetPool.GiveNumberOfObjects() << "\t" << this->TetPool.GiveCapacity() << "\n";
+}
+
 void MeshData::DoSanityCheck()
 {
+    // Check that the slot indices match the positions in the lists
+    for (size_t i = 0; i < this->Edges.size(); i++) {
+        if ((this->Edges[i] != NULL) && (this->Edges[i]->SlotIndex != i)) {
+            LOG("Edge %lld has slot index %u but is located at %u\n", (long long) this->Edges[i]->ID,
+                this->Edges[i]->SlotIndex, i);
+            throw (0);
+        }
+    }
+    for (size_t i = 0; i < this->Triangles.size(); i++) {
+        if ((this->Triangles[i] != NULL) && (this->Triangles[i]->SlotIndex != i)) {
+            LOG("Triangle %lld has slot index %u but is located at %u\n", (long long) this->Triangles[i]->ID,
+                this->Triangles[i]->SlotIndex, i);
+            throw (0);
+        }
+    }
+
     // Check edge for duplicates and make sure that each edge conatins two unique vertices
     for (size_t i = 0; i < this->Edges.size(); i++) {
         EdgeType *e1 = this->Edges[i];
+        if (e1 == NULL) {
+            continue;
+        }
         if (e1->Vertices[0] == e1->Vertices[1]) {
             LOG ("Edge is a point\n", 0);
             throw (0);
         }
         for (size_t j = i + 1; j < this->Edges.size(); j++) {
             EdgeType *e2 = this->Edges[j];
+            if (e2 == NULL) {
+                continue;
+            }
             if (((e1->Vertices[0] == e2->Vertices[0]) & (e1->Vertices[1] == e2->Vertices[1])) |
                 ((e1->Vertices[0] == e2->Vertices[1]) & (e1->Vertices[1] == e2->Vertices[0]))) {
-                LOG("Duplicate edge! %u@%p (%u, %u) and %u@%p (%u, %u)\n", e1->ID, e1, e1->Vertices[0]->ID,
-                    e1->Vertices[1]->ID, e2->ID, e2, e2->Vertices[0]->ID, e2->Vertices[1]->ID);
+                LOG("Duplicate edge! %lld@%p (%lld, %lld) and %lld@%p (%lld, %lld)\n", (long long) e1->ID, e1,
+                    (long long) e1->Vertices[0]->ID, (long long) e1->Vertices[1]->ID, (long long) e2->ID, e2,
+                    (long long) e2->Vertices[0]->ID, (long long) e2->Vertices[1]->ID);
+                throw (0);
+            }
+        }
+    }
+
+    // Check that the cycles of the topology are consistent
+    this->Topology.DoSanityCheck();
+
+    // Check that the edges of each triangle connect its vertices, that the topology agrees with the triangle and that
+    // the triangle lists of the edges contain exactly the triangles referring to them
+    size_t NumberOfTriangleEdges = 0;
+    for (TriangleType *t : this->Triangles) {
+        if (t == NULL) {
+            continue;
+        }
+        if ((t->TopologyIndex == NoTopologyIndex) || (this->Topology.GiveTriangle(t->TopologyIndex) != t)) {
+            LOG("Triangle %lld is not in the topology\n", (long long) t->ID);
+            throw (0);
+        }
+        for (int i = 0; i < 3; i++) {
+            EdgeType *e = t->Edges[i];
+            VertexType *v0 = t->Vertices[i];
+            VertexType *v1 = t->Vertices[(i + 1) % 3];
+            if ((e == NULL) || !(((e->Vertices[0] == v0) & (e->Vertices[1] == v1)) |
+                                 ((e->Vertices[1] == v0) & (e->Vertices[0] == v1)))) {
+                LOG("Edge %u of triangle %lld does not connect vertices %lld and %lld\n", i, (long long) t->ID,
+                    (long long) v0->ID, (long long) v1->ID);
+                throw (0);
+            }
+            if ((this->Topology.GiveCornerVertex(t->TopologyIndex, i) != v0->TopologyIndex) ||
+                (this->Topology.GiveHalfEdgeEdge(t->TopologyIndex, i) != e->TopologyIndex)) {
+                LOG("Corner %u of triangle %lld differs from the topology\n", i, (long long) t->ID);
+                throw (0);
+            }
+            TopologyCycle<TriangleType, 3> EdgeTriangles = this->Topology.GiveEdgeTriangles(e->TopologyIndex);
+            if (std::count(EdgeTriangles.begin(), EdgeTriangles.end(), t) != 1) {
+                LOG("Triangle %lld is not listed once by its edge %lld\n", (long long) t->ID, (long long) e->ID);
                 throw (0);
             }
+            NumberOfTriangleEdges++;
         }
     }
 
+    size_t NumberOfEdgeTriangles = 0;
+    for (EdgeType *e : this->Edges) {
+        if (e == NULL) {
+            continue;
+        }
+        if ((e->TopologyIndex == NoTopologyIndex) || (this->Topology.GiveEdge(e->TopologyIndex) != e) ||
+            (this->Topology.GiveEdgeVertex(e->TopologyIndex, 0) != e->Vertices[0]->TopologyIndex) ||
+            (this->Topology.GiveEdgeVertex(e->TopologyIndex, 1) != e->Vertices[1]->TopologyIndex)) {
+            LOG("Edge %lld differs from the topology\n", (long long) e->ID);
+            throw (0);
+        }
+        NumberOfEdgeTriangles += this->Topology.GiveEdgeTriangles(e->TopologyIndex).size();
+    }
+    if (NumberOfEdgeTriangles != NumberOfTriangleEdges) {
+        LOG("Edges refer to %u triangles while triangles refer to %u edges\n", NumberOfEdgeTriangles,
+            NumberOfTriangleEdges);
+        throw (0);
+    }
+
     // Check list of edges and triangles and ensure that each edge at least holds two triangles
 /*    bool EdgeMissing = false;
     for (TriangleType *t: this->Triangles) {
@@ -82,7 +165,7 @@ void MeshData::DoSanityCheck()
 
             if (!EdgeFound) {
                 EdgeMissing = true;
-                LOG("\tTriangle %u, edge %u\n", t->ID, i);
+                LOG("\tTriangle %lld, edge %u\n", (long long) t->ID, i);
             }
 
         }
@@ -122,12 +205,12 @@ void MeshData::DoSanityCheck()
         std::vector<VertexType *> InTriNotEdges;
         std::set_difference(VerticesTriangles.begin(), VerticesTriangles.end(), VerticesEdges.begin(), VerticesEdges.end(), std::inserter(InTriNotEdges, InTriNotEdges.end()));
         LOG("Vertices in triangles not on any edge:\n", 0);
-        for (VertexType *v: InTriNotEdges) {LOG("\t%u\n", v->ID);}
+        for (VertexType *v: InTriNotEdges) {LOG("\t%lld\n", (long long) v->ID);}
 
         std::vector<VertexType *> OnEdgesNotTri;
         std::set_difference(VerticesEdges.begin(), VerticesEdges.end(), VerticesTriangles.begin(), VerticesTriangles.end(), std::inserter(OnEdgesNotTri, OnEdgesNotTri.end()));
         LOG("Vertices on edge not in any triangle:\n", 0);
-        for (VertexType *v: OnEdgesNotTri) {LOG("\t%u\n", v->ID);}
+        for (VertexType *v: OnEdgesNotTri) {LOG("\t%lld\n", (long long) v->ID);}
 
         throw(0);
     } */
@@ -287,32 +370,34 @@ void MeshData::ExportVolume(std::string FileName, Exporter_FileTypes FileType)
     free(exporter);
 }
 
-EdgeType *MeshData::AddEdge(std::array<int, 2> VertexIDs)
+EdgeType *MeshData::AddEdge(std::array<IDType, 2> VertexIDs)
 {
-    EdgeType *NewEdge = new EdgeType;
+    EdgeType *NewEdge = this->EdgePool.Allocate();
     for (unsigned int i : {0, 1}) {
         NewEdge->Vertices.at(i) = this->Vertices.at(VertexIDs.at(i));
     }
 
-    return AddEdge(NewEdge);
+    EdgeType *Edge = AddEdge(NewEdge);
+    if (Edge != NewEdge) {
+        this->EdgePool.Release(NewEdge);
+    }
+    return Edge;
 }
 
 EdgeType *MeshData::AddEdge(EdgeType *e)
 {
-    LOG("Create edge from Vertex IDs %u and %u: %p\n", e->Vertices[0]->ID, e->Vertices[1]->ID, e);
+    LOG("Create edge from Vertex IDs %lld and %lld: %p\n", (long long) e->Vertices[0]->ID,
+        (long long) e->Vertices[1]->ID, e);
 
     // Check if edge already exists (only check edges connected to the first vertex)
     VertexType *ThisVertex = e->Vertices[0];
     VertexType *OtherVertex = e->Vertices[1];
 
-    std::vector<EdgeType *> Edges = e->Vertices.at(0)->Edges;
-
-    for (auto Edge : Edges) {
-        if (((Edge->Vertices[0] == ThisVertex) & (Edge->Vertices[1] == OtherVertex)) |
-            ((Edge->Vertices[1] == ThisVertex) & (Edge->Vertices[0] == OtherVertex))) {
-            LOG("Edge %u@%p already exists\n", Edge->ID, Edge);
-            return Edge;
-        }
+    TopologyIndexType ExistingEdge = this->Topology.FindEdge(ThisVertex->TopologyIndex, OtherVertex->TopologyIndex);
+    if (ExistingEdge != NoTopologyIndex) {
+        EdgeType *Edge = this->Topology.GiveEdge(ExistingEdge);
+        LOG("Edge %lld@%p already exists\n", (long long) Edge->ID, Edge);
+        return Edge;
     }
 
     if (e->Vertices[0] == e->Vertices[1]) {
@@ -322,40 +407,111 @@ EdgeType *MeshData::AddEdge(EdgeType *e)
 
     e->ID = this->EdgeCounter;
     this->EdgeCounter++;
-    for (VertexType *v : e->Vertices) {
-        v->AddEdge(e);
-    }
-    LOG("Add edge %u@%p from vertices (%u, %u)\n", e->ID, e, e->Vertices[0]->ID, e->Vertices[1]->ID);
+    e->TopologyIndex = this->Topology.AddEdge(ThisVertex->TopologyIndex, OtherVertex->TopologyIndex, e);
+    LOG("Add edge %lld@%p from vertices (%lld, %lld)\n", (long long) e->ID, e, (long long) e->Vertices[0]->ID,
+        (long long) e->Vertices[1]->ID);
+    e->SlotIndex = this->Edges.size();
     this->Edges.push_back(e);
     return e;
 }
 
 void MeshData::RemoveEdge(EdgeType *e)
 {
-    LOG("Remove edge %u@%p (%u, %u)\n", e->ID, e, e->Vertices[0]->ID, e->Vertices[1]->ID);
-    for (VertexType *v : e->Vertices) {
-        v->RemoveEdge(e);
-    }
-    this->Edges.erase(std::remove(this->Edges.begin(), this->Edges.end(), e), this->Edges.end());
-    delete e;
+    LOG("Remove edge %lld@%p (%lld, %lld)\n", (long long) e->ID, e, (long long) e->Vertices[0]->ID,
+        (long long) e->Vertices[1]->ID);
+    this->Topology.RemoveEdge(e->TopologyIndex);
+    this->Edges[e->SlotIndex] = NULL;
+    this->NumberOfRemovedEdges++;
+    this->EdgePool.Release(e);
     e = NULL;
+
+    if (this->SweepDepth == 0) {
+        this->CompactEntityLists();
+    }
 }
 
 void MeshData::RemoveTriangle(TriangleType *t)
 {
-    LOG("Remove triangle %u\n", t->ID);
-    for (VertexType *v : t->Vertices) {
-        v->RemoveTriangle(t);
-    }
-    this->Triangles.erase(std::remove(this->Triangles.begin(), this->Triangles.end(), t), this->Triangles.end());
-    delete t;
+    LOG("Remove triangle %lld\n", (long long) t->ID);
+    this->Topology.RemoveTriangle(t->TopologyIndex);
+    this->Triangles[t->SlotIndex] = NULL;
+    this->NumberOfRemovedTriangles++;
+    this->TrianglePool.Release(t);
     t = NULL;
+
+    if (this->SweepDepth == 0) {
+        this->CompactEntityLists();
+    }
+}
+
+void MeshData::BeginSweep()
+{
+    this->SweepDepth++;
+}
+
+void MeshData::EndSweep()
+{
+    this->SweepDepth--;
+    if (this->SweepDepth == 0) {
+        this->CompactEntityLists();
+    }
+}
+
+void MeshData::CompactEntityLists()
+{
+    if (this->NumberOfRemovedEdges > 0) {
+        size_t j = 0;
+        for (size_t i = 0; i < this->Edges.size(); i++) {
+            if (this->Edges[i] != NULL) {
+                this->Edges[i]->SlotIndex = j;
+                this->Edges[j++] = this->Edges[i];
+            }
+        }
+        this->Edges.resize(j);
+        this->NumberOfRemovedEdges = 0;
+    }
+
+    if (this->NumberOfRemovedTriangles > 0) {
+        size_t j = 0;
+        for (size_t i = 0; i < this->Triangles.size(); i++) {
+            if (this->Triangles[i] != NULL) {
+                this->Triangles[i]->SlotIndex = j;
+                this->Triangles[j++] = this->Triangles[i];
+            }
+        }
+        this->Triangles.resize(j);
+        this->NumberOfRemovedTriangles = 0;
+    }
+}
+
+void MeshData::MoveEdgeEnd(EdgeType *e, int End, VertexType *v)
+{
+    this->Topology.MoveEdgeEnd(e->TopologyIndex, End, v->TopologyIndex);
+    e->Vertices[End] = v;
+}
+
+void MeshData::ConnectTriangleToEdges(TriangleType *t)
+{
+    std::array<TopologyIndexType, 3> VertexIndices, EdgeIndices;
+    for (int i = 0; i < 3; i++) {
+        VertexType *v0 = t->Vertices[i];
+        VertexType *v1 = t->Vertices[(i + 1) % 3];
+        EdgeIndices[i] = this->Topology.FindEdge(v0->TopologyIndex, v1->TopologyIndex);
+        if (EdgeIndices[i] == NoTopologyIndex) {
+            LOG("No edge between vertices %lld and %lld of triangle %lld\n", (long long) v0->ID, (long long) v1->ID,
+                (long long) t->ID);
+            throw (0);
+        }
+        t->Edges[i] = this->Topology.GiveEdge(EdgeIndices[i]);
+        VertexIndices[i] = v0->TopologyIndex;
+    }
+    t->TopologyIndex = this->Topology.AddTriangle(VertexIndices, EdgeIndices, t);
 }
 
 TriangleType *MeshData::AddTriangle(std::array<double, 3> v0, std::array<double, 3> v1, std::array<double, 3> v2)
 {
     // Insert vertices and create a triangle using the indices returned
-    int VertexIDs[3];
+    IDType VertexIDs[3];
 
     VertexIDs[0] = this->VertexOctreeRoot->AddVertex(v0[0], v0[1], v0[2]);
     VertexIDs[1] = this->VertexOctreeRoot->AddVertex(v1[0], v1[1], v1[2]);
@@ -364,11 +520,11 @@ TriangleType *MeshData::AddTriangle(std::array<double, 3> v0, std::array<double,
     return this->AddTriangle({VertexIDs[0], VertexIDs[1], VertexIDs[2]});
 }
 
-TriangleType *MeshData::AddTriangle(std::array<int, 3> VertexIDs)
+TriangleType *MeshData::AddTriangle(std::array<IDType, 3> VertexIDs)
 {
-    TriangleType *NewTriangle = new TriangleType;
-    LOG("Create triangle %p from vertices (%u, %u, %u)@(%p, %p, %p)\n", NewTriangle, VertexIDs.at(0),
-        VertexIDs.at(1), VertexIDs.at(2),
+    TriangleType *NewTriangle = this->TrianglePool.Allocate();
+    LOG("Create triangle %p from vertices (%lld, %lld, %lld)@(%p, %p, %p)\n", NewTriangle,
+        (long long) VertexIDs.at(0), (long long) VertexIDs.at(1), (long long) VertexIDs.at(2),
         this->Vertices.at(VertexIDs.at(0)), this->Vertices.at(VertexIDs.at(1)), this->Vertices.at(VertexIDs.at(2)));
 
     for (int i = 0; i < 3; i++) {
@@ -379,9 +535,7 @@ TriangleType *MeshData::AddTriangle(std::array<int, 3> VertexIDs)
         }
     }
 
-    // Update vertices and triangles with references to each other
     for (int i = 0; i < 3; i++) {
-        this->Vertices.at(VertexIDs.at(i))->AddTriangle(NewTriangle);
         NewTriangle->Vertices[i] = this->Vertices.at(VertexIDs.at(i));
     }
 
@@ -395,7 +549,8 @@ TriangleType *MeshData::AddTriangle(TriangleType *NewTriangle)
     for ( TriangleType *t : this->Triangles ) {
         bool permutation = std :: is_permutation( t->Vertices.begin(), t->Vertices.end(), NewTriangle->Vertices.begin() );
         if ( permutation ) {
-            STATUS("\nTriangle already exist. Existing ID = %u (index %u in list)!\n", t->ID, i); //TODO: Add a logging command for errors
+            //TODO: Add a logging command for errors
+            STATUS("\nTriangle already exist. Existing ID = %lld (index %u in list)!\n", (long long) t->ID, i);
             return t;
 
             throw 0;
@@ -404,22 +559,171 @@ TriangleType *MeshData::AddTriangle(TriangleType *NewTriangle)
     }
 #endif
 
-    NewTriangle->UpdateNormal();
     NewTriangle->ID = TriangleCounter;
-    LOG("Add triangle %u to set\n", NewTriangle->ID);
+    LOG("Add triangle %lld to set\n", (long long) NewTriangle->ID);
 
-    for (VertexType *v : NewTriangle->Vertices) {
-        v->AddTriangle(NewTriangle);
-    }
+    this->ConnectTriangleToEdges(NewTriangle);
 
     TriangleCounter++;
+    NewTriangle->SlotIndex = this->Triangles.size();
     this->Triangles.push_back(NewTriangle);
     return NewTriangle;
 }
 
-TetType *MeshData::AddTetrahedron(std::array<int, 4> VertexIDs)
+/**
+ * @brief Vertex pair of a triangle edge, smallest vertex ID first, and the position of the edge in the triangle list
+ */
+typedef struct
+{
+    IDType Low;
+    IDType High;
+    size_t Occurrence;
+} EdgeOccurrenceType;
+
+/**
+ * @brief Sorts edge occurrences by vertex pair using a stable least significant digit radix sort. Thus, occurrences of
+ * the same pair remain in their original order.
+ * @param List List to sort
+ * @param VertexBits Number of bits needed to represent any vertex ID
+ */
+static void RadixSortEdgeOccurrences(std::vector<EdgeOccurrenceType> &List, int VertexBits)
+{
+    const int DigitBits = 11;
+    const size_t NumberOfBuckets = (size_t) 1 << DigitBits;
+    const uint64_t DigitMask = NumberOfBuckets - 1;
+
+    std::vector<EdgeOccurrenceType> Buffer(List.size());
+    std::vector<size_t> Offsets(NumberOfBuckets);
+
+    for (IDType EdgeOccurrenceType::*Field : {&EdgeOccurrenceType::High, &EdgeOccurrenceType::Low}) {
+        for (int Shift = 0; Shift < VertexBits; Shift += DigitBits) {
+            std::fill(Offsets.begin(), Offsets.end(), 0);
+            for (EdgeOccurrenceType &e : List) {
+                Offsets[((uint64_t) (e.*Field) >> Shift) & DigitMask]++;
+            }
+            size_t Sum = 0;
+            for (size_t &Offset : Offsets) {
+                size_t Count = Offset;
+                Offset = Sum;
+                Sum += Count;
+            }
+            for (EdgeOccurrenceType &e : List) {
+                Buffer[Offsets[((uint64_t) (e.*Field) >> Shift) & DigitMask]++] = e;
+            }
+            List.swap(Buffer);
+        }
+    }
+}
+
+std::vector<TriangleType *> MeshData::AddTriangles(const std::vector<IDType> &TriangleVertexIDs,
+                                                   const std::vector<int> &InterfaceIDs,
+                                                   std::vector<EdgeType *> *TriangleEdges)
+{
+    size_t NumberOfTriangles = TriangleVertexIDs.size() / 3;
+    size_t NumberOfOccurrences = NumberOfTriangles * 3;
+
+    // Collect the vertex pairs of all triangle edges. Occurrence i connects vertex i and the following vertex of the
+    // triangle, which is the order AddTriangle creates edges in.
+    std::vector<EdgeOccurrenceType> Occurrences(NumberOfOccurrences);
+    for (size_t i = 0; i < NumberOfOccurrences; i++) {
+        IDType v0 = TriangleVertexIDs[i];
+        IDType v1 = TriangleVertexIDs[(i % 3 == 2) ? i - 2 : i + 1];
+        if (v0 == v1) {
+            STATUS("Vertices are the same\n", 0);
+            throw (0);
+        }
+        Occurrences[i] = {std::min(v0, v1), std::max(v0, v1), i};
+    }
+
+    int VertexBits = 1;
+    while (((size_t) 1 << VertexBits) < this->Vertices.size()) {
+        VertexBits++;
+    }
+    RadixSortEdgeOccurrences(Occurrences, VertexBits);
+
+    // Each run of equal vertex pairs is one edge. Since the sort is stable, the first item of a run is the first
+    // occurrence of the edge.
+    std::vector<size_t> EdgeOfOccurrence(NumberOfOccurrences);
+    std::vector<bool> IsFirstOccurrence(NumberOfOccurrences, false);
+    size_t NumberOfEdges = 0;
+    for (size_t i = 0; i < NumberOfOccurrences; i++) {
+        if ((i == 0) || (Occurrences[i].Low != Occurrences[i - 1].Low) ||
+            (Occurrences[i].High != Occurrences[i - 1].High)) {
+            IsFirstOccurrence[Occurrences[i].Occurrence] = true;
+            NumberOfEdges++;
+        }
+        EdgeOfOccurrence[Occurrences[i].Occurrence] = NumberOfEdges - 1;
+    }
+    std::vector<EdgeOccurrenceType>().swap(Occurrences);
+
+    // Create edges in order of first occurrence, which gives the same IDs as adding the triangles one at a time. Edges
+    // already in the mesh are reused.
+    bool CheckExistingEdges = (this->Edges.size() > 0);
+    std::vector<EdgeType *> NewEdges(NumberOfEdges);
+    this->Edges.reserve(this->Edges.size() + NumberOfEdges);
+
+    for (size_t i = 0; i < NumberOfOccurrences; i++) {
+        if (!IsFirstOccurrence[i]) {
+            continue;
+        }
+        VertexType *v0 = this->Vertices.at(TriangleVertexIDs[i]);
+        VertexType *v1 = this->Vertices.at(TriangleVertexIDs[(i % 3 == 2) ? i - 2 : i + 1]);
+
+        EdgeType *e = NULL;
+        if (CheckExistingEdges) {
+            TopologyIndexType ExistingEdge = this->Topology.FindEdge(v0->TopologyIndex, v1->TopologyIndex);
+            if (ExistingEdge != NoTopologyIndex) {
+                e = this->Topology.GiveEdge(ExistingEdge);
+            }
+        }
+
+        if (e == NULL) {
+            e = this->EdgePool.Allocate();
+            e->Vertices = {{v0, v1}};
+            e->ID = this->EdgeCounter;
+            this->EdgeCounter++;
+            e->SlotIndex = this->Edges.size();
+            e->TopologyIndex = this->Topology.AddEdge(v0->TopologyIndex, v1->TopologyIndex, e);
+            this->Edges.push_back(e);
+        }
+        NewEdges[EdgeOfOccurrence[i]] = e;
+    }
+
+    // Create triangles
+    std::vector<TriangleType *> NewTriangles(NumberOfTriangles);
+    this->Triangles.reserve(this->Triangles.size() + NumberOfTriangles);
+
+    for (size_t t = 0; t < NumberOfTriangles; t++) {
+        TriangleType *NewTriangle = this->TrianglePool.Allocate();
+        std::array<TopologyIndexType, 3> VertexIndices, EdgeIndices;
+        for (int i = 0; i < 3; i++) {
+            NewTriangle->Vertices[i] = this->Vertices.at(TriangleVertexIDs[t * 3 + i]);
+            NewTriangle->Edges[i] = NewEdges[EdgeOfOccurrence[t * 3 + i]];
+            VertexIndices[i] = NewTriangle->Vertices[i]->TopologyIndex;
+            EdgeIndices[i] = NewTriangle->Edges[i]->TopologyIndex;
+        }
+        NewTriangle->TopologyIndex = this->Topology.AddTriangle(VertexIndices, EdgeIndices, NewTriangle);
+        NewTriangle->InterfaceID = InterfaceIDs[t];
+        NewTriangle->ID = this->TriangleCounter;
+        this->TriangleCounter++;
+        NewTriangle->SlotIndex = this->Triangles.size();
+        this->Triangles.push_back(NewTriangle);
+        NewTriangles[t] = NewTriangle;
+    }
+
+    if (TriangleEdges != NULL) {
+        TriangleEdges->resize(NumberOfOccurrences);
+        for (size_t i = 0; i < NumberOfOccurrences; i++) {
+            TriangleEdges->at(i) = NewEdges[EdgeOfOccurrence[i]];
+        }
+    }
+
+    return NewTriangles;
+}
+
+TetType *MeshData::AddTetrahedron(std::array<IDType, 4> VertexIDs)
 {
-    TetType *NewTet = new TetType;
+    TetType *NewTet = this->TetPool.Allocate();
     NewTet->Vertices = {{this->Vertices.at(VertexIDs[0]), this->Vertices.at(VertexIDs[1]), this->Vertices.at(
             VertexIDs[2]), this->Vertices.at(VertexIDs[3])}};
     return this->AddTetrahedron(NewTet);
@@ -446,7 +750,7 @@ std::vector<TriangleType *> MeshData::GetTrianglesAround(std::array<double, 3> c
 
     std::vector<TriangleType *> NearTriangles;
     for (VertexType *v : NearVertices) {
-        for (TriangleType *t : v->Triangles) {
+        for (TriangleType *t : v->GiveTriangles()) {
             NearTriangles.push_back(t);
         }
     }
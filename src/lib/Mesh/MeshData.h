@@ -6,6 +6,7 @@
 #include <algorithm>
 
 #include "MeshComponents.h"
+#include "ObjectPool.h"
 #include "VertexOctreeNode.h"
 #include "VTKExport.h"
 #include "SimpleExporter.h"
@@ -29,8 +30,36 @@ enum FC_MESH
 class MeshData
 {
 private:
-    int TriangleCounter;
-    int EdgeCounter;
+    IDType TriangleCounter;
+    IDType EdgeCounter;
+
+    /**
+     * @brief Number of sweeps currently active, cf. BeginSweep
+     */
+    int SweepDepth;
+
+    /**
+     * @brief Number of NULL entries in Edges left by RemoveEdge during a sweep
+     */
+    size_t NumberOfRemovedEdges;
+
+    /**
+     * @brief Number of NULL entries in Triangles left by RemoveTriangle during a sweep
+     */
+    size_t NumberOfRemovedTriangles;
+
+    /**
+     * @brief Removes the NULL entries from Edges and Triangles while keeping the order of the remaining entries, and
+     * updates the slot indices.
+     */
+    void CompactEntityLists();
+
+    /**
+     * @brief Sets the edges of a triangle and adds the triangle to Topology. All three edges must already be in the
+     * mesh.
+     * @param t Triangle
+     */
+    void ConnectTriangleToEdges(TriangleType *t);
 
 public:
 
@@ -45,7 +74,7 @@ public:
     BoundingBoxType BoundingBox;
 
     /**
-     * @brief List of all triangles in the mesh
+     * @brief List of all triangles in the mesh. During a sweep (cf. BeginSweep) the list may contain NULL entries.
      */
     std::vector<TriangleType *> Triangles;
 
@@ -55,7 +84,7 @@ public:
     std::vector<VertexType *> Vertices;
 
     /**
-     * @brief List of all edges in the mesh
+     * @brief List of all edges in the mesh. During a sweep (cf. BeginSweep) the list may contain NULL entries.
      */
     std::vector<EdgeType *> Edges;
 
@@ -64,6 +93,32 @@ public:
      */
     std::vector<TetType *> Tets;
 
+    /**
+     * @brief Coordinates of the vertices and connectivity of the vertices, edges and triangles of the mesh
+     */
+    MeshTopology Topology;
+
+    /**
+     * @brief Pool of vertices. All vertices of the mesh are allocated from the pool and are freed with the mesh.
+     */
+    ObjectPool<VertexType> VertexPool;
+
+    /**
+     * @brief Pool of edges. Edges passed to AddEdge(EdgeType *) must be allocated from the pool.
+     */
+    ObjectPool<EdgeType> EdgePool;
+
+    /**
+     * @brief Pool of triangles. Triangles passed to AddTriangle(TriangleType *) must be allocated from the pool, and
+     * triangles that are not added to the mesh should be released to it.
+     */
+    ObjectPool<TriangleType> TrianglePool;
+
+    /**
+     * @brief Pool of tetrahedrons. Tetrahedrons passed to AddTetrahedron(TetType *) must be allocated from the pool.
+     */
+    ObjectPool<TetType> TetPool;
+
     /**
      * @brief VertexOctreeNode root object for all vertices. Uses octree algorithm for performance.
      */
@@ -92,6 +147,12 @@ public:
      */
     void ExportVolume(std::string FileName, Exporter_FileTypes FileType);
 
+    /**
+     * @brief Writes the number of allocations made by each of the entity pools
+     * @param Stream Output stream
+     */
+    void WriteAllocationStatistics(std::ostream &Stream);
+
     /**
      * @brief Adds an Edge object to Edges given vertex IDs
      *
@@ -102,7 +163,7 @@ public:
      * @param VertexIDs Vertex indices
      * @return Reference to EdgeType object
      */
-    EdgeType *AddEdge(std::array<int, 2> VertexIDs);
+    EdgeType *AddEdge(std::array<IDType, 2> VertexIDs);
 
     // Adds and edge object to list and update vertices
     /**
@@ -114,17 +175,40 @@ public:
     EdgeType *AddEdge(EdgeType *e);
 
     /**
-     * @brief Remove EdgeType object from Edges
+     * @brief Remove EdgeType object from Edges. During a sweep, the entry of the edge is set to NULL in constant time.
+     * Otherwise, the list is compacted at once.
      * @param e Pointer to EdgeType object to remove
      */
     void RemoveEdge(EdgeType *e);
 
     /**
-     * @brief Removes Triangle from Triangles list
+     * @brief Moves one end of an edge to another vertex. The triangles of the edge must be updated separately.
+     * @param e Edge
+     * @param End End of the edge to move, 0 or 1
+     * @param v New vertex of the end
+     */
+    void MoveEdgeEnd(EdgeType *e, int End, VertexType *v);
+
+    /**
+     * @brief Removes Triangle from Triangles list. During a sweep, the entry of the triangle is set to NULL in constant
+     * time. Otherwise, the list is compacted at once.
      * @param t Pointer to triangle object to remove
      */
     void RemoveTriangle(TriangleType *t);
 
+    /**
+     * @brief Starts a sweep over Edges or Triangles. Until the matching call to EndSweep, removed edges and triangles
+     * leave NULL entries in the lists, i.e. the indices of all other entries stay valid and removal is done in constant
+     * time. Entries added during the sweep are appended. Sweeps may be nested.
+     */
+    void BeginSweep();
+
+    /**
+     * @brief Ends a sweep started by BeginSweep. When the outermost sweep ends, the NULL entries are removed from Edges
+     * and Triangles.
+     */
+    void EndSweep();
+
     // Adds a triangle using coordinates
     /**
      * @brief Adds Triangle a TriangleType object to the Triangles list given coordinates
@@ -140,7 +224,7 @@ public:
      * @param VertexIDs Array of vertex IDs
      * @return If triangle already exists, a pointer to that object is returned. If not, a pointer to the newly created object is returned.
      */
-    TriangleType *AddTriangle(std::array<int, 3> VertexIDs);
+    TriangleType *AddTriangle(std::array<IDType, 3> VertexIDs);
 
     /**
      * @brief Adds a TriangleType object to Triangles list given a pointer to an TriangleType object
@@ -149,12 +233,29 @@ public:
      */
     TriangleType *AddTriangle(TriangleType *NewTriangle);
 
+    /**
+     * @brief Adds many triangles at once given vertex IDs.
+     *
+     * The edges are found by sorting the vertex pairs of all triangle edges, after which edges, triangles and the lists
+     * of edges and triangles on each vertex are set up in linear passes. The result is the same as calling
+     * AddTriangle(std::array<IDType, 3>) for each triangle in turn, except that there is no check for duplicate triangles.
+     *
+     * @param TriangleVertexIDs Three vertex IDs per triangle
+     * @param InterfaceIDs Interface ID of each triangle
+     * @param TriangleEdges Output (optional). Three edges per triangle, where edge i connects vertex i and i+1 (modulo 3)
+     * of the triangle.
+     * @return Pointers to the new triangles
+     */
+    std::vector<TriangleType *> AddTriangles(const std::vector<IDType> &TriangleVertexIDs,
+                                             const std::vector<int> &InterfaceIDs,
+                                             std::vector<EdgeType *> *TriangleEdges = NULL);
+
     /**
      * @brief Adds a TetType object to the Tets list given vertex IDs
      * @param VertexIDs Array of vertex IDs
      * @return Returns pointer to the added TetType object
      */
-    TetType *AddTetrahedron(std::array<int, 4> VertexIDs);
+    TetType *AddTetrahedron(std::array<IDType, 4> VertexIDs);
 
     /**
      * @brief Adds a TetType object to the Tets list given a pointer to a TetType object
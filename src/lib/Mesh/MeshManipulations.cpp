@@ -19,6 +19,9 @@ MeshManipulations::MeshManipulations(BoundingBoxType BoundingBox) : MeshData(Bou
 
     TOL_COL_MAXVOLUMECHANGE = .5 * .5 * .5 * 2;
     TOL_COL_MAXERROR_ACCUMULATED = .5 * .5 * .5;
+
+    LongestEdgeLength = 0.0;
+    LongestEdgeCount = 0;
 }
 
 void MeshManipulations::SortEdgesByLength()
@@ -33,6 +36,7 @@ void MeshManipulations::SortEdgesByLength()
 
     this->Edges.clear();
     for (std::pair<double, EdgeType *> epair : EdgeLength) {
+        epair.second->SlotIndex = this->Edges.size();
         this->Edges.push_back(epair.second);
     }
 }
@@ -60,6 +64,7 @@ void MeshManipulations::SortEdgesByMinArea()
 
     this->Edges.clear();
     for (std::pair<double, EdgeType *> epair : EdgeArea) {
+        epair.second->SlotIndex = this->Edges.size();
         this->Edges.push_back(epair.second);
     }
 }
@@ -67,7 +72,7 @@ void MeshManipulations::SortEdgesByMinArea()
 FC_MESH MeshManipulations::GetFlippedEdgeData(EdgeType *EdgeToFlip, EdgeType *NewEdge,
                                               std::array<TriangleType *, 2> *NewTriangles)
 {
-    LOG("Get flipped edge data for edge %u@%p\n", EdgeToFlip->ID, EdgeToFlip);
+    LOG("Get flipped edge data for edge %lld@%p\n", (long long) EdgeToFlip->ID, EdgeToFlip);
 
     std::vector<TriangleType *> EdgeTriangles = EdgeToFlip->GiveTriangles();
 
@@ -111,8 +116,10 @@ FC_MESH MeshManipulations::GetFlippedEdgeData(EdgeType *EdgeToFlip, EdgeType *Ne
 
                 // Produce new triangles
                 TriangleType *new_t0, *new_t1;
-                new_t0 = new TriangleType({NewEdgeVertices[1], NewEdgeVertices[0], t0edge[0]});
-                new_t1 = new TriangleType({NewEdgeVertices[0], NewEdgeVertices[1], t0edge[1]});
+                new_t0 = this->TrianglePool.Allocate(
+                        std::array<VertexType *, 3>{{NewEdgeVertices[1], NewEdgeVertices[0], t0edge[0]}});
+                new_t1 = this->TrianglePool.Allocate(
+                        std::array<VertexType *, 3>{{NewEdgeVertices[0], NewEdgeVertices[1], t0edge[1]}});
 
                 new_t0->PosNormalMatID = new_t1->PosNormalMatID = EdgeTriangles[0]->PosNormalMatID;
                 new_t0->NegNormalMatID = new_t1->NegNormalMatID = EdgeTriangles[0]->NegNormalMatID;
@@ -148,7 +155,8 @@ FC_MESH MeshManipulations::GetFlippedEdgeData(EdgeType *EdgeToFlip, EdgeType *Ne
 FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
 {
 
-    LOG("Flip edge %u@%p (%u, %u)\n", Edge->ID, Edge, Edge->Vertices[0]->ID, Edge->Vertices[1]->ID);
+    LOG("Flip edge %lld@%p (%lld, %lld)\n", (long long) Edge->ID, Edge, (long long) Edge->Vertices[0]->ID,
+        (long long) Edge->Vertices[1]->ID);
 
     std::vector<TriangleType *> EdgeTriangles = Edge->GiveTriangles();
 
@@ -156,7 +164,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     if (EdgeTriangles.size() != 2) {
         LOG("\tUnable to flip edge. To many or only one triangle connected\n", 0);
         for (TriangleType *t : EdgeTriangles) {
-            LOG("\t\t%u\n", t->ID);
+            LOG("\t\t%lld\n", (long long) t->ID);
         }
         return FC_TOOMANYTRIANGLES;
     }
@@ -189,8 +197,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     if (FC != FC_OK) {
         LOG("\tUnable to flip edge. Changes in normal direction prevents flipping\n", 0);
         for (TriangleType *t : NewTriangles) {
-            delete t;
-            t = NULL;
+            this->TrianglePool.Release(t);
         }
         return FC;
     }
@@ -203,8 +210,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
         LOG("\tUnable to flip edge. New minimal angles worse than current (New: %f, Current: %f).\n", minAngleNew,
             minAngleCurrent);
         for (TriangleType *t : NewTriangles) {
-            delete t;
-            t = NULL;
+            this->TrianglePool.Release(t);
         }
         return FC_WORSEMINANGLE;
     }
@@ -213,8 +219,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     if (fabs(minAngleNew - minAngleCurrent) < 1e-8) {
         LOG("\tUnable to flip edge. Flipping does not improve quality\n", minAngleNew, minAngleCurrent);
         for (TriangleType *t : NewTriangles) {
-            delete t;
-            t = NULL;
+            this->TrianglePool.Release(t);
         }
         return FC_ANGLESNOTIMPROVED;
     }
@@ -226,8 +231,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     if (std::fabs(CurrentArea - NewArea) > TOL_FLIP_MAXAREACHANGE) {
         LOG("The combined area of the triangles changes too much. Prevent flipping.\n", 0);
         for (TriangleType *t : NewTriangles) {
-            delete t;
-            t = NULL;
+            this->TrianglePool.Release(t);
         }
         return FC_AREACHANGETOOLARGE;
     }
@@ -235,7 +239,7 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     // Check if any of the new triangles already exist
     std::vector<TriangleType *> ConnectedTriangles;
     for (VertexType *v : NewEdge.Vertices) {
-        for (TriangleType *t : v->Triangles) {
+        for (TriangleType *t : v->GiveTriangles()) {
             ConnectedTriangles.push_back(t);
         }
     }
@@ -245,6 +249,9 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
     for (unsigned int i = 0; i < ConnectedTriangles.size() - 1; i++) {
         if (ConnectedTriangles.at(i) == ConnectedTriangles.at(i + 1)) {
             LOG("Edge already exists!\n", 0);
+            for (TriangleType *t : NewTriangles) {
+                this->TrianglePool.Release(t);
+            }
             return FC_INVALIDEDGE;
         }
     }
@@ -270,6 +277,9 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
             FC_MESH R = this->CheckTrianglePenetration(t1, t2);
             if (R != FC_OK) {
                 LOG("Unable to flip edge. Will result in penetration\n", 0);
+                for (TriangleType *t : NewTriangles) {
+                    this->TrianglePool.Release(t);
+                }
                 return R;
             }
         }
@@ -280,23 +290,14 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
 
     // Update mesh data
 
-    // Remove triangles from verices
+    // Move edge to the new vertices
     for (int i : {0, 1}) {
-        for (TriangleType *t : EdgeTriangles) {
-            Edge->Vertices[i]->RemoveTriangle(t);
-        }
+        this->MoveEdgeEnd(Edge, i, NewEdge.Vertices[i]);
     }
 
-    // Remove edge from vertices
-    for (int i : {0, 1}) {
-        Edge->Vertices[i]->RemoveEdge(Edge);
-    }
-
-    // Add new edge to vertices
-    for (int i : {0, 1}) {
-        Edge->Vertices[i] = NewEdge.Vertices[i];
-        Edge->Vertices[i]->AddEdge(Edge);
-    }
+    // The flipped edge may be longer than any other edge. The old length is not removed from LongestEdgeCount, i.e.
+    // LongestEdgeLength remains an upper bound on the edge lengths.
+    this->RegisterEdgeLength(Edge->GiveLength());
 
     // Add new triangles list (and thus also to vertices)
     for (TriangleType *t : NewTriangles) {
@@ -312,7 +313,8 @@ FC_MESH MeshManipulations::FlipEdge(EdgeType *Edge, bool SkipIntersectionCheck)
         this->RemoveTriangle(t);
     }
 
-    LOG("Edge %u@%p (%u, %u) is now flipped\n", Edge->ID, Edge, Edge->Vertices[0]->ID, Edge->Vertices[1]->ID);
+    LOG("Edge %lld@%p (%lld, %lld) is now flipped\n", (long long) Edge->ID, Edge, (long long) Edge->Vertices[0]->ID,
+        (long long) Edge->Vertices[1]->ID);
 
     return FC_OK;
 }
@@ -474,9 +476,9 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
     VertexType *RemoveVertex = EdgeToCollapse->Vertices[RemoveVertexIndex];
     VertexType *SaveVertex = EdgeToCollapse->Vertices[SaveVertexIndex];
 
-    LOG("Collapse edge %u@%p (%u, %u) by removing vertex %u\n", EdgeToCollapse->ID, EdgeToCollapse,
-        EdgeToCollapse->Vertices[0]->ID,
-        EdgeToCollapse->Vertices[1]->ID, RemoveVertex->ID);
+    LOG("Collapse edge %lld@%p (%lld, %lld) by removing vertex %lld\n", (long long) EdgeToCollapse->ID, EdgeToCollapse,
+        (long long) EdgeToCollapse->Vertices[0]->ID,
+        (long long) EdgeToCollapse->Vertices[1]->ID, (long long) RemoveVertex->ID);
 
     // Cannot remove a fixed vertex
     if (RemoveVertex->IsFixedVertex()) {
@@ -494,25 +496,24 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
     // Create new triangles. These are create by moving RemoveVertex to the other end of the edge and remove the 0-area triangles
     std::vector<TriangleType *> TrianglesToRemove = EdgeToCollapse->GiveTriangles();
 
-    LOG("Connected triangle IDs: %u, %u\n", TrianglesToRemove.at(0)->ID, TrianglesToRemove.at(1)->ID);
-    std::vector<TriangleType *> ConnectedTriangles = RemoveVertex->Triangles;
+    LOG("Connected triangle IDs: %lld, %lld\n", (long long) TrianglesToRemove.at(0)->ID,
+        (long long) TrianglesToRemove.at(1)->ID);
+    TopologyCycle<TriangleType, 3> RemoveVertexTriangles = RemoveVertex->GiveTriangles();
+    std::vector<TriangleType *> ConnectedTriangles(RemoveVertexTriangles.begin(), RemoveVertexTriangles.end());
 
-    std::sort(TrianglesToRemove.begin(), TrianglesToRemove.end());
-    std::sort(ConnectedTriangles.begin(), ConnectedTriangles.end());
+    // Sort by ID rather than by address to make the outcome independent of where the entities are allocated
+    std::sort(TrianglesToRemove.begin(), TrianglesToRemove.end(), SortByID<TriangleType *>);
+    std::sort(ConnectedTriangles.begin(), ConnectedTriangles.end(), SortByID<TriangleType *>);
 
     std::vector<TriangleType *> TrianglesToSave;
     std::set_difference(ConnectedTriangles.begin(), ConnectedTriangles.end(),
                         TrianglesToRemove.begin(), TrianglesToRemove.end(),
-                        std::inserter(TrianglesToSave, TrianglesToSave.begin()));
-
-    std::sort(TrianglesToSave.begin(), TrianglesToSave.end(),
-              SortByID<TriangleType *>); //TODO: Why cant we use SortByID in the above sort and set_difference functions?
+                        std::back_inserter(TrianglesToSave), SortByID<TriangleType *>);
 
     // NewTriangles is the updated subset of of TrianglesToSave with the removed vertex changed to the saved vertex
     std::vector<TriangleType *> NewTriangles;
     for (TriangleType *t : TrianglesToSave) {
-        t->UpdateNormal();
-        TriangleType *NewTriangle = new TriangleType;
+        TriangleType *NewTriangle = this->TrianglePool.Allocate();
 
         // Copy data
         NewTriangle->InterfaceID = t->InterfaceID;
@@ -521,8 +522,6 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
         NewTriangle->PosNormalMatID = t->PosNormalMatID;
         NewTriangle->NegNormalMatID = t->NegNormalMatID;
 
-        NewTriangle->UpdateNormal();
-
         for (int i = 0; i < 3; i++) {
             if (t->Vertices[i] == RemoveVertex) {
                 NewTriangle->Vertices[i] = SaveVertex;
@@ -531,7 +530,6 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
             }
         }
 
-        NewTriangle->UpdateNormal();
         NewTriangles.push_back(NewTriangle);
     }
 
@@ -546,8 +544,7 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
 
     if (FC != FC_OK) {
         for (TriangleType *t : NewTriangles) {
-            delete t;
-            t = NULL;
+            this->TrianglePool.Release(t);
         }
         return FC;
     }
@@ -558,7 +555,8 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
 
     // Find edges to remove (all edges connected to RemoveVertex and in any triangle in TrianglesToRemove)
     std::vector<EdgeType *> EdgesToRemove;
-    std::vector<EdgeType *> RemoveVertexEdges = RemoveVertex->Edges;
+    TopologyCycle<EdgeType, 2> RemoveVertexCycle = RemoveVertex->GiveEdges();
+    std::vector<EdgeType *> RemoveVertexEdges(RemoveVertexCycle.begin(), RemoveVertexCycle.end());
 
     std::vector<EdgeType *> TriangleToRemoveEdges;
     for (TriangleType *t : TrianglesToRemove) {
@@ -567,38 +565,39 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
         }
     }
 
-    std::sort(RemoveVertexEdges.begin(), RemoveVertexEdges.end());
-    std::sort(TriangleToRemoveEdges.begin(), TriangleToRemoveEdges.end());
+    std::sort(RemoveVertexEdges.begin(), RemoveVertexEdges.end(), SortByID<EdgeType *>);
+    std::sort(TriangleToRemoveEdges.begin(), TriangleToRemoveEdges.end(), SortByID<EdgeType *>);
 
     std::set_intersection(RemoveVertexEdges.begin(), RemoveVertexEdges.end(),
                           TriangleToRemoveEdges.begin(), TriangleToRemoveEdges.end(),
-                          std::back_inserter(EdgesToRemove));
+                          std::back_inserter(EdgesToRemove), SortByID<EdgeType *>);
 
     // Update edges
     std::vector<EdgeType *> ConnectedEdges;
     std::set_difference(RemoveVertexEdges.begin(), RemoveVertexEdges.end(), EdgesToRemove.begin(), EdgesToRemove.end(),
-                        std::back_inserter(ConnectedEdges));
+                        std::back_inserter(ConnectedEdges), SortByID<EdgeType *>);
 
     // Ensure that we don't end up with copies edges, i.e. moves one edge onto another. This means that we "snap of" a volume
-    std::vector<EdgeType *> SaveVertexEdges = SaveVertex->Edges;
-
-    for (EdgeType *se: SaveVertexEdges) {
+    for (EdgeType *se: SaveVertex->GiveEdges()) {
         if (se != EdgeToCollapse) {
             for (EdgeType *ce: ConnectedEdges) {
 
                 // Construct updated edge
-                EdgeType UpdatedConnectedEdge = *ce;
+                std::array<VertexType *, 2> UpdatedConnectedEdge = ce->Vertices;
                 for (size_t i = 0; i < 2; i++) {
-                    if (UpdatedConnectedEdge.Vertices[i] == RemoveVertex) {
-                        UpdatedConnectedEdge.Vertices[i] = SaveVertex;
+                    if (UpdatedConnectedEdge[i] == RemoveVertex) {
+                        UpdatedConnectedEdge[i] = SaveVertex;
                     }
                 }
 
                 //Compare
-                if (((se->Vertices[0] == UpdatedConnectedEdge.Vertices[0]) &
-                     (se->Vertices[1] == UpdatedConnectedEdge.Vertices[1])) |
-                    ((se->Vertices[0] == UpdatedConnectedEdge.Vertices[1]) &
-                     (se->Vertices[1] == UpdatedConnectedEdge.Vertices[0]))) {
+                if (((se->Vertices[0] == UpdatedConnectedEdge[0]) &
+                     (se->Vertices[1] == UpdatedConnectedEdge[1])) |
+                    ((se->Vertices[0] == UpdatedConnectedEdge[1]) &
+                     (se->Vertices[1] == UpdatedConnectedEdge[0]))) {
+                    for (TriangleType *t : NewTriangles) {
+                        this->TrianglePool.Release(t);
+                    }
                     return FC_INVALIDEDGE;
                 }
 
@@ -611,9 +610,7 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
             for (int i : {0, 1}) {
                 // "Move" vertex
                 if (e->Vertices[i] == RemoveVertex) {
-                    e->Vertices[i]->RemoveEdge(e);
-                    e->Vertices[i] = SaveVertex;
-                    e->Vertices[i]->AddEdge(e);
+                    this->MoveEdgeEnd(e, i, SaveVertex);
                 }
             }
         }
@@ -636,13 +633,12 @@ FC_MESH MeshManipulations::CollapseEdge(EdgeType *EdgeToCollapse, int RemoveVert
 
     // DoSanityCheck();
 
-    ConnectedEdges = SaveVertex->Edges;
     bool edgeflipped = true;
     while (edgeflipped) {
         edgeflipped = false;
         size_t i = 0;
-        while (i < SaveVertex->Edges.size()) {
-            EdgeType *e = SaveVertex->Edges[i];
+        while (i < SaveVertex->GiveEdges().size()) {
+            EdgeType *e = SaveVertex->GiveEdges()[i];
             if (FlipEdge(e) != FC_OK) {
                 //FlipEdge(e);
                 LOG("Failed to flip edge\n", 0);
@@ -826,7 +822,7 @@ FC_MESH MeshManipulations::CheckCoarsenChord(EdgeType *EdgeToCollapse, VertexTyp
 
     // Find the other edge connected to RemoveVertex (the one connected to the same PhaseEdge)
     std::vector<VertexType *> ConnectedVertices = RemoveVertexPhaseEdge->GiveVerticesConnectedToVertex(RemoveVertex);
-    if (ConnectedVertices.size() == 1) {
+    if (ConnectedVertices.size() < 2) {
         // This should be ok if the edge is small. This simply removes the (very small) chord.
         // Note that this can imply duplicate triangles and it is quite cumbersome to solve this. Thus, we push this feature forward
         double EdgeLength = EdgeToCollapse->GiveLength();
@@ -834,6 +830,8 @@ FC_MESH MeshManipulations::CheckCoarsenChord(EdgeType *EdgeToCollapse, VertexTyp
         if (EdgeLength > .25) {
             return FC_CHORD;
         }
+        // There is no other edge segment to compare the direction of the chord with
+        return FC_OK;
     }
     VertexType *OtherVertex = (ConnectedVertices[0] == SaveVertex) ? ConnectedVertices[1] : ConnectedVertices[0];
     NewEdge = {{SaveVertex, OtherVertex}};
@@ -892,7 +890,7 @@ std::vector<VertexType *> MeshManipulations::FindIndependentSet()
                 bool AddToSet = true;
 
                 // Add v to IndepSet if no neighbour is in the set
-                for (EdgeType *e : v->Edges) {
+                for (EdgeType *e : v->GiveEdges()) {
                     VertexType *w;
                     if (e->Vertices[0] == v) {
                         w = e->Vertices[1];
@@ -921,12 +919,18 @@ int MeshManipulations::FlipAll(bool SkipIntersectionCheck)
     int flipcount = 0;
     int i = 0;
     bool edgeflipped = true;
+    this->BeginSweep();
     while (edgeflipped) {
         edgeflipped = false;
         size_t j = 0;
         while (j < this->Edges.size()) {
             EdgeType *e = this->Edges[j];
-            LOG("Flip edge iteration %u: edge @%p (%u, %u)\n", i, e, e->Vertices[0]->ID, e->Vertices[1]->ID);
+            if (e == NULL) {
+                j++;
+                continue;
+            }
+            LOG("Flip edge iteration %u: edge @%p (%lld, %lld)\n", i, e, (long long) e->Vertices[0]->ID,
+                (long long) e->Vertices[1]->ID);
             if (this->FlipEdge(e, SkipIntersectionCheck) == FC_OK) {
                 flipcount++;
                 edgeflipped = true;
@@ -936,15 +940,64 @@ int MeshManipulations::FlipAll(bool SkipIntersectionCheck)
             i++;
         }
     }
+    this->EndSweep();
     return flipcount;
 }
 
 void MeshManipulations::UpdateLongestEdgeLength()
 {
     this->LongestEdgeLength = 0;
+    this->LongestEdgeCount = 0;
     for (EdgeType *e: this->Edges) {
-        double ThisLength = e->GiveLength();
-        this->LongestEdgeLength = std::max(ThisLength, this->LongestEdgeLength);
+        if (e == NULL) {
+            continue;
+        }
+        this->RegisterEdgeLength(e->GiveLength());
+    }
+}
+
+void MeshManipulations::RegisterEdgeLength(double Length)
+{
+    if (Length > this->LongestEdgeLength) {
+        this->LongestEdgeLength = Length;
+        this->LongestEdgeCount = 1;
+    } else if (Length == this->LongestEdgeLength) {
+        this->LongestEdgeCount++;
+    }
+}
+
+size_t MeshManipulations::CountLongestEdges(VertexType *v0, VertexType *v1)
+{
+    size_t Count = 0;
+    for (EdgeType *e : v0->GiveEdges()) {
+        if (e->GiveLength() == this->LongestEdgeLength) {
+            Count++;
+        }
+    }
+    for (EdgeType *e : v1->GiveEdges()) {
+        // Edges connecting v0 and v1 are already counted
+        if ((e->Vertices[0] != v0) && (e->Vertices[1] != v0) && (e->GiveLength() == this->LongestEdgeLength)) {
+            Count++;
+        }
+    }
+    return Count;
+}
+
+void MeshManipulations::UpdateLongestEdgeLength(VertexType *SaveVertex, size_t LongestEdgesBefore,
+                                                 double LongestEdgeLengthBefore)
+{
+    // If a flip during the collapse produced a longer edge, LongestEdgeCount no longer includes the edges counted
+    // before the collapse
+    if (this->LongestEdgeLength == LongestEdgeLengthBefore) {
+        this->LongestEdgeCount -= LongestEdgesBefore;
+    }
+    for (EdgeType *e : SaveVertex->GiveEdges()) {
+        this->RegisterEdgeLength(e->GiveLength());
+    }
+
+    // All edges of the longest length are gone. The new longest edge can be anywhere.
+    if (this->LongestEdgeCount == 0) {
+        this->UpdateLongestEdgeLength();
     }
 }
 
@@ -973,29 +1026,40 @@ void MeshManipulations::CoarsenMesh()
 
         // Find independent sets. Vertices belonging to IndepSet cannot be collapsed (according to de Cougnt)
         std::vector<VertexType *> IndepSet = FindIndependentSet();
+        std::vector<bool> IsInIndepSet(this->Vertices.size(), false);
         for (VertexType *v : this->Vertices) {
             v->tag = 0;
         }
         for (VertexType *v : IndepSet) {
             v->tag = 1;
+            IsInIndepSet[v->ID] = true;
         }
 
         unsigned int i = 0;
 
+        // Removed edges are set to NULL until the sweep ends, i.e. the edges not yet visited keep their positions
+        this->BeginSweep();
         while (i < this->Edges.size()) {
             STATUS("%c[2K\rCoarsening iteration %u, collapse edge %u (%u)", 27, iter, i, this->Edges.size());
             fflush(stdout);
 
             EdgeType *e = this->Edges.at(i);
+            if (e == NULL) {
+                i++;
+                continue;
+            }
             // Try to collapse vertices on current edge
             std::array<VertexType *, 2> EdgeVertices = {{e->Vertices[0], e->Vertices[1]}};
             int vi = 0;
             for (VertexType *v : EdgeVertices) {
                 // If vertex v is not in the set of independent vertices, try to collapse
-                if (std::find(IndepSet.begin(), IndepSet.end(), v) == IndepSet.end()) {
+                if (!IsInIndepSet[v->ID]) {
+                    VertexType *SaveVertex = EdgeVertices[1 - vi];
+                    double LongestEdgeLengthBefore = this->LongestEdgeLength;
+                    size_t LongestEdgesBefore = this->CountLongestEdges(v, SaveVertex);
                     FC_MESH CollapseResult = this->CollapseEdge(e, vi);
                     if (CollapseResult == FC_OK) {
-                        this->UpdateLongestEdgeLength();
+                        this->UpdateLongestEdgeLength(SaveVertex, LongestEdgesBefore, LongestEdgeLengthBefore);
                         CoarseningOccurs = true;
 #if EXPORT_MESH_COARSENING
                         this->ExportSurface(strfmt("/tmp/Coarseningp_%u.simple", MeshIndex), FT_SIMPLE);
@@ -1008,8 +1072,8 @@ void MeshManipulations::CoarsenMesh()
 
                         break;
                     } else {
-                        LOG ("Failed to collapse edge %u by removing vertex %u\n due to reason ", e->ID, vi,
-                             CollapseResult);
+                        LOG ("Failed to collapse edge %lld by removing vertex %u\n due to reason ", (long long) e->ID,
+                             vi, CollapseResult);
                     }
 
                 }
@@ -1017,6 +1081,7 @@ void MeshManipulations::CoarsenMesh()
             }
             i++;
         }
+        this->EndSweep();
         iter++;
 
 
@@ -1049,11 +1114,16 @@ void MeshManipulations::CoarsenMesh()
 
         size_t i = 0;
 
+        this->BeginSweep();
         while (i < this->Triangles.size()) {
             STATUS("%c[2K\rCleanup iteration %u, edge %u (%u)", 27, iter, i, this->Edges.size());
             fflush(stdout);
 
             TriangleType *t = this->Triangles.at(i);
+            if (t == NULL) {
+                i++;
+                continue;
+            }
 
             int VertexIndex;
             double Angle = t->GiveSmallestAngle(&VertexIndex);
@@ -1079,6 +1149,7 @@ void MeshManipulations::CoarsenMesh()
 
             i++;
         }
+        this->EndSweep();
         CleanupIteration++;
         std::sort(Reasons.begin(), Reasons.end());
         this->FlipAll();
@@ -1101,7 +1172,8 @@ int MeshManipulations::CleanupTetrahedrals()
     for (TetType *t: this->Tets) {
         int SmallestAngleIndex;
         double theta = t->GiveSmallestDihedralAngle(SmallestAngleIndex);
-        LOG("Smallest dihedral angle for tet %u is %f (%f degrees)\n", t->ID, theta, theta * 360 / (2 * 3.1415));
+        LOG("Smallest dihedral angle for tet %lld is %f (%f degrees)\n", (long long) t->ID, theta,
+            theta * 360 / (2 * 3.1415));
         Angles.push_back({t, theta});
 
         double Volume = t->GiveVolume();
@@ -1145,14 +1217,15 @@ bool MeshManipulations::RemoveTetrahedron(int index)
      *
     */
 
-    LOG("Move Vertex %u to %u to remove element %u\n", v0->ID, v1->ID, t->ID);
+    LOG("Move Vertex %lld to %lld to remove element %lld\n", (long long) v0->ID, (long long) v1->ID, (long long) t->ID);
     this->Tets.erase(std::remove(this->Tets.begin(), this->Tets.end(), t));
 
     for (TetType *thist: this->Tets) {
         for (VertexType *v: thist->Vertices) {
             if (v == v0) {
                 if (!(v->Fixed[0] | v->Fixed[1] | v->Fixed[2])) {
-                    LOG("Move vertex %u to %u (change tet %u)\n", v->ID, v1->ID, thist->ID);
+                    LOG("Move vertex %lld to %lld (change tet %lld)\n", (long long) v->ID, (long long) v1->ID,
+                        (long long) thist->ID);
                     //v1->set_c({{0.5*(v0->get_c(0)+v1->get_c(0)), 0.5*(v0->get_c(1)+v1->get_c(1)), 0.5*(v0->get_c(2)+v1->get_c(2))}});
                     v = v1;
                 } else {
@@ -44,6 +44,37 @@ private:
      */
     void SortEdgesByMinArea();
 
+    /**
+     * @brief Number of edges with length LongestEdgeLength
+     */
+    size_t LongestEdgeCount;
+
+    /**
+     * @brief Updates LongestEdgeLength and LongestEdgeCount for an edge which is new or has changed
+     * @param Length Length of edge
+     */
+    void RegisterEdgeLength(double Length);
+
+    /**
+     * @brief Counts the edges of length LongestEdgeLength connected to any of two vertices
+     * @param v0 Vertex
+     * @param v1 Vertex
+     * @return Number of edges
+     */
+    size_t CountLongestEdges(VertexType *v0, VertexType *v1);
+
+    /**
+     * @brief Updates LongestEdgeLength after an edge collapse. All edges removed or changed by a collapse are connected
+     * to the vertices of the collapsed edge. The changed edges are connected to the saved vertex afterwards, except
+     * those flipped at the end of the collapse, which are registered by FlipEdge. Hence, only the edges of the saved
+     * vertex need to be considered unless all edges of the longest length are removed.
+     * @param SaveVertex Vertex kept by the collapse
+     * @param LongestEdgesBefore Number of edges of length LongestEdgeLength connected to the vertices of the collapsed
+     * edge before the collapse, as given by CountLongestEdges
+     * @param LongestEdgeLengthBefore LongestEdgeLength before the collapse
+     */
+    void UpdateLongestEdgeLength(VertexType *SaveVertex, size_t LongestEdgesBefore, double LongestEdgeLengthBefore);
+
 public:
 
     /**
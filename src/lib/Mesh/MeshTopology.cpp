@@ -0,0 +1,338 @@
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include "MeshTopology.h"
+#include "MiscFunctions.h"
+
+namespace voxel2tet
+{
+/**
+ * @brief Appends a node to a cycle
+ * @param Next Next node of each node
+ * @param Last Last node of the cycle, NoTopologyIndex if empty. Updated.
+ * @param Node Node to append
+ */
+static void AppendToCycle(std::vector<TopologyIndexType> &Next, TopologyIndexType &Last, TopologyIndexType Node)
+{
+    if (Last == NoTopologyIndex) {
+        Next[Node] = Node;
+    } else {
+        Next[Node] = Next[Last];
+        Next[Last] = Node;
+    }
+    Last = Node;
+}
+
+/**
+ * @brief Gives the node preceding a node in its cycle
+ */
+static TopologyIndexType GivePreviousNode(const std::vector<TopologyIndexType> &Next, TopologyIndexType Node)
+{
+    TopologyIndexType Previous = Node;
+    while (Next[Previous] != Node) {
+        Previous = Next[Previous];
+    }
+    return Previous;
+}
+
+/**
+ * @brief Removes a node from a cycle while keeping the order of the other nodes
+ * @param Next Next node of each node
+ * @param Last Last node of the cycle. Updated.
+ * @param Node Node to remove
+ */
+static void RemoveFromCycle(std::vector<TopologyIndexType> &Next, TopologyIndexType &Last, TopologyIndexType Node)
+{
+    TopologyIndexType Previous = GivePreviousNode(Next, Node);
+    if (Previous == Node) {
+        Last = NoTopologyIndex;
+    } else {
+        Next[Previous] = Next[Node];
+        if (Last == Node) {
+            Last = Previous;
+        }
+    }
+    Next[Node] = NoTopologyIndex;
+}
+
+/**
+ * @brief Lets two nodes of different cycles take the place of each other
+ * @param Next Next node of each node
+ * @param LastA Last node of the cycle of NodeA. Updated.
+ * @param LastB Last node of the cycle of NodeB. Updated.
+ * @param NodeA Node of the first cycle
+ * @param NodeB Node of the second cycle
+ */
+static void SwapCycleNodes(std::vector<TopologyIndexType> &Next, TopologyIndexType &LastA, TopologyIndexType &LastB,
+                           TopologyIndexType NodeA, TopologyIndexType NodeB)
+{
+    TopologyIndexType PreviousA = GivePreviousNode(Next, NodeA);
+    TopologyIndexType PreviousB = GivePreviousNode(Next, NodeB);
+    TopologyIndexType NextA = Next[NodeA];
+    TopologyIndexType NextB = Next[NodeB];
+
+    if (PreviousA == NodeA) {
+        Next[NodeB] = NodeB;
+    } else {
+        Next[PreviousA] = NodeB;
+        Next[NodeB] = NextA;
+    }
+    if (PreviousB == NodeB) {
+        Next[NodeA] = NodeA;
+    } else {
+        Next[PreviousB] = NodeA;
+        Next[NodeA] = NextB;
+    }
+
+    if (LastA == NodeA) {
+        LastA = NodeB;
+    }
+    if (LastB == NodeB) {
+        LastB = NodeA;
+    }
+}
+
+template <typename T>
+static size_t GiveVectorMemoryUsage(const std::vector<T> &Vector)
+{
+    return Vector.capacity() * sizeof(T);
+}
+
+TopologyIndexType MeshTopology::GiveNewIndex(size_t Count)
+{
+    // Corners are indexed three per triangle, so the number of triangles is bounded by a third of the index range
+    if (Count >= (size_t) std::numeric_limits<TopologyIndexType>::max() / 3) {
+        LOG("Number of mesh entities exceeds the range of TopologyIndexType (%u bytes)\n",
+            (unsigned int) sizeof(TopologyIndexType));
+        throw std::overflow_error("Number of mesh entities exceeds the range of TopologyIndexType");
+    }
+    return (TopologyIndexType) Count;
+}
+
+TopologyIndexType MeshTopology::AddVertex(double x, double y, double z)
+{
+    TopologyIndexType v = GiveNewIndex(this->GiveNumberOfVertices());
+    this->Coordinates[0].push_back(x);
+    this->Coordinates[1].push_back(y);
+    this->Coordinates[2].push_back(z);
+    this->VertexLastCorner.push_back(NoTopologyIndex);
+    this->VertexLastEnd.push_back(NoTopologyIndex);
+    return v;
+}
+
+TopologyIndexType MeshTopology::AddEdge(TopologyIndexType v0, TopologyIndexType v1, EdgeType *Edge)
+{
+    TopologyIndexType e;
+    if (!this->FreeEdges.empty()) {
+        e = this->FreeEdges.back();
+        this->FreeEdges.pop_back();
+    } else {
+        e = GiveNewIndex(this->EdgeObjects.size());
+        this->EndVertex.resize(this->EndVertex.size() + 2);
+        this->NextEnd.resize(this->NextEnd.size() + 2);
+        this->EdgeLastHalfEdge.push_back(NoTopologyIndex);
+        this->EdgeObjects.push_back(NULL);
+    }
+
+    this->EdgeObjects[e] = Edge;
+    this->EdgeLastHalfEdge[e] = NoTopologyIndex;
+    this->EndVertex[2 * e] = v0;
+    this->EndVertex[2 * e + 1] = v1;
+    AppendToCycle(this->NextEnd, this->VertexLastEnd[v0], 2 * e);
+    AppendToCycle(this->NextEnd, this->VertexLastEnd[v1], 2 * e + 1);
+    return e;
+}
+
+void MeshTopology::RemoveEdge(TopologyIndexType e)
+{
+    if (this->EdgeLastHalfEdge[e] != NoTopologyIndex) {
+        LOG("Edge %llu is removed while still part of a triangle\n", (unsigned long long) e);
+        throw (0);
+    }
+    for (TopologyIndexType End : {2 * e, 2 * e + 1}) {
+        RemoveFromCycle(this->NextEnd, this->VertexLastEnd[this->EndVertex[End]], End);
+        this->EndVertex[End] = NoTopologyIndex;
+    }
+    this->EdgeObjects[e] = NULL;
+    this->FreeEdges.push_back(e);
+}
+
+void MeshTopology::MoveEdgeEnd(TopologyIndexType e, int End, TopologyIndexType v)
+{
+    TopologyIndexType Node = 2 * e + End;
+    RemoveFromCycle(this->NextEnd, this->VertexLastEnd[this->EndVertex[Node]], Node);
+    this->EndVertex[Node] = v;
+    AppendToCycle(this->NextEnd, this->VertexLastEnd[v], Node);
+}
+
+TopologyIndexType MeshTopology::FindEdge(TopologyIndexType v0, TopologyIndexType v1) const
+{
+    TopologyIndexType Last = this->VertexLastEnd[v0];
+    if (Last == NoTopologyIndex) {
+        return NoTopologyIndex;
+    }
+    TopologyIndexType Node = Last;
+    do {
+        Node = this->NextEnd[Node];
+        // The other end of the edge is found by flipping the lowest bit
+        if (this->EndVertex[Node ^ 1] == v1) {
+            return Node / 2;
+        }
+    } while (Node != Last);
+    return NoTopologyIndex;
+}
+
+TopologyIndexType MeshTopology::AddTriangle(const std::array<TopologyIndexType, 3> &Vertices,
+                                            const std::array<TopologyIndexType, 3> &Edges, TriangleType *Triangle)
+{
+    TopologyIndexType t;
+    if (!this->FreeTriangles.empty()) {
+        t = this->FreeTriangles.back();
+        this->FreeTriangles.pop_back();
+    } else {
+        t = GiveNewIndex(this->TriangleObjects.size());
+        this->CornerVertex.resize(this->CornerVertex.size() + 3);
+        this->NextCorner.resize(this->NextCorner.size() + 3);
+        this->HalfEdgeEdge.resize(this->HalfEdgeEdge.size() + 3);
+        this->NextHalfEdge.resize(this->NextHalfEdge.size() + 3);
+        this->TriangleObjects.push_back(NULL);
+    }
+
+    this->TriangleObjects[t] = Triangle;
+    for (int i = 0; i < 3; i++) {
+        TopologyIndexType Corner = 3 * t + i;
+        this->CornerVertex[Corner] = Vertices[i];
+        AppendToCycle(this->NextCorner, this->VertexLastCorner[Vertices[i]], Corner);
+    }
+    for (int i = 0; i < 3; i++) {
+        TopologyIndexType HalfEdge = 3 * t + i;
+        this->HalfEdgeEdge[HalfEdge] = Edges[i];
+        AppendToCycle(this->NextHalfEdge, this->EdgeLastHalfEdge[Edges[i]], HalfEdge);
+    }
+    return t;
+}
+
+void MeshTopology::RemoveTriangle(TopologyIndexType t)
+{
+    for (int i = 0; i < 3; i++) {
+        TopologyIndexType Corner = 3 * t + i;
+        RemoveFromCycle(this->NextCorner, this->VertexLastCorner[this->CornerVertex[Corner]], Corner);
+        this->CornerVertex[Corner] = NoTopologyIndex;
+        RemoveFromCycle(this->NextHalfEdge, this->EdgeLastHalfEdge[this->HalfEdgeEdge[Corner]], Corner);
+        this->HalfEdgeEdge[Corner] = NoTopologyIndex;
+    }
+    this->TriangleObjects[t] = NULL;
+    this->FreeTriangles.push_back(t);
+}
+
+void MeshTopology::FlipTriangle(TopologyIndexType t)
+{
+    TopologyIndexType c0 = 3 * t, c1 = 3 * t + 1, c2 = 3 * t + 2;
+
+    // Corner 0 takes the place of corner 1 at the vertex of corner 1 and vice versa. Nodes in the same cycle, as in
+    // degenerate triangles, are left in place.
+    if (this->CornerVertex[c0] != this->CornerVertex[c1]) {
+        SwapCycleNodes(this->NextCorner, this->VertexLastCorner[this->CornerVertex[c0]],
+                       this->VertexLastCorner[this->CornerVertex[c1]], c0, c1);
+        std::swap(this->CornerVertex[c0], this->CornerVertex[c1]);
+    }
+
+    // Half-edge 0 still connects corners 0 and 1, while half-edges 1 and 2 trade places
+    if (this->HalfEdgeEdge[c1] != this->HalfEdgeEdge[c2]) {
+        SwapCycleNodes(this->NextHalfEdge, this->EdgeLastHalfEdge[this->HalfEdgeEdge[c1]],
+                       this->EdgeLastHalfEdge[this->HalfEdgeEdge[c2]], c1, c2);
+        std::swap(this->HalfEdgeEdge[c1], this->HalfEdgeEdge[c2]);
+    }
+}
+
+void MeshTopology::DoSanityCheck() const
+{
+    // Each node must be in the cycle of the vertex or edge it refers to. Following the cycles from their last nodes
+    // must visit each node exactly once.
+    std::vector<TopologyIndexType> CornersVisited(this->CornerVertex.size(), 0);
+    std::vector<TopologyIndexType> HalfEdgesVisited(this->HalfEdgeEdge.size(), 0);
+    std::vector<TopologyIndexType> EndsVisited(this->EndVertex.size(), 0);
+
+    for (size_t v = 0; v < this->GiveNumberOfVertices(); v++) {
+        TopologyIndexType Last = this->VertexLastCorner[v];
+        for (TopologyIndexType Node = Last; Node != NoTopologyIndex;) {
+            Node = this->NextCorner[Node];
+            if ((this->CornerVertex[Node] != v) || (CornersVisited[Node]++ > 0)) {
+                LOG("Corner %llu in the corner cycle of vertex %llu is invalid\n", (unsigned long long) Node,
+                    (unsigned long long) v);
+                throw (0);
+            }
+            Node = (Node == Last) ? NoTopologyIndex : Node;
+        }
+
+        Last = this->VertexLastEnd[v];
+        for (TopologyIndexType Node = Last; Node != NoTopologyIndex;) {
+            Node = this->NextEnd[Node];
+            if ((this->EndVertex[Node] != v) || (EndsVisited[Node]++ > 0)) {
+                LOG("Edge end %llu in the disk cycle of vertex %llu is invalid\n", (unsigned long long) Node,
+                    (unsigned long long) v);
+                throw (0);
+            }
+            Node = (Node == Last) ? NoTopologyIndex : Node;
+        }
+    }
+
+    for (size_t e = 0; e < this->EdgeObjects.size(); e++) {
+        TopologyIndexType Last = this->EdgeLastHalfEdge[e];
+        for (TopologyIndexType Node = Last; Node != NoTopologyIndex;) {
+            Node = this->NextHalfEdge[Node];
+            if ((this->HalfEdgeEdge[Node] != e) || (HalfEdgesVisited[Node]++ > 0)) {
+                LOG("Half-edge %llu in the radial cycle of edge %llu is invalid\n", (unsigned long long) Node,
+                    (unsigned long long) e);
+                throw (0);
+            }
+            Node = (Node == Last) ? NoTopologyIndex : Node;
+        }
+    }
+
+    for (size_t t = 0; t < this->TriangleObjects.size(); t++) {
+        if (this->TriangleObjects[t] == NULL) {
+            continue;
+        }
+        for (size_t Corner = 3 * t; Corner < 3 * t + 3; Corner++) {
+            if ((CornersVisited[Corner] != 1) || (HalfEdgesVisited[Corner] != 1)) {
+                LOG("Corner %llu of triangle %llu is missing from its cycles\n", (unsigned long long) Corner,
+                    (unsigned long long) t);
+                throw (0);
+            }
+        }
+    }
+
+    for (size_t e = 0; e < this->EdgeObjects.size(); e++) {
+        if (this->EdgeObjects[e] == NULL) {
+            continue;
+        }
+        for (size_t End = 2 * e; End < 2 * e + 2; End++) {
+            if (EndsVisited[End] != 1) {
+                LOG("End %llu of edge %llu is missing from its disk cycle\n", (unsigned long long) End,
+                    (unsigned long long) e);
+                throw (0);
+            }
+        }
+    }
+}
+
+size_t MeshTopology::GiveMemoryUsage() const
+{
+    size_t Memory = 0;
+    for (const std::vector<double> &c : this->Coordinates) {
+        Memory += GiveVectorMemoryUsage(c);
+    }
+    for (const std::vector<TopologyIndexType> *Indices : {&this->VertexLastCorner, &this->VertexLastEnd,
+                                                          &this->EndVertex, &this->NextEnd, &this->EdgeLastHalfEdge,
+                                                          &this->FreeEdges, &this->CornerVertex, &this->NextCorner,
+                                                          &this->HalfEdgeEdge, &this->NextHalfEdge,
+                                                          &this->FreeTriangles}) {
+        Memory += GiveVectorMemoryUsage(*Indices);
+    }
+    Memory += GiveVectorMemoryUsage(this->EdgeObjects) + GiveVectorMemoryUsage(this->TriangleObjects);
+    return Memory;
+}
+
+}
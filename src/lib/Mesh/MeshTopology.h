@@ -0,0 +1,378 @@
+#ifndef MESHTOPOLOGY_H
+#define MESHTOPOLOGY_H
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+namespace voxel2tet
+{
+
+#ifndef VOXEL2TET_TOPOLOGY_INDEX_TYPE
+#define VOXEL2TET_TOPOLOGY_INDEX_TYPE uint32_t
+#endif
+
+/**
+ * @brief Unsigned integer type of the indices of vertices, edges, triangles and their corners in MeshTopology. Defaults to
+ * 32 bits, i.e. half the size of a pointer. Since corners are indexed three per triangle, a mesh can then hold at most
+ * (2^32 - 1) / 3, i.e. about 1.4e9, vertices, edges or triangles, which is fewer than IDType allows. Adding more throws
+ * std::overflow_error. Can be changed by defining VOXEL2TET_TOPOLOGY_INDEX_TYPE, e.g. to uint64_t for larger meshes.
+ */
+typedef VOXEL2TET_TOPOLOGY_INDEX_TYPE TopologyIndexType;
+
+/**
+ * @brief Index marking the end of a cycle or an entity not in a MeshTopology
+ */
+const TopologyIndexType NoTopologyIndex = (TopologyIndexType) -1;
+
+class EdgeType;
+
+class TriangleType;
+
+/**
+ * @brief Range over the entities of one cycle of a MeshTopology, in the order they were added to the cycle.
+ *
+ * The nodes of a cycle are corners of triangles (Stride 3) or ends of edges (Stride 2), and the entity of node n is
+ * Objects[n / Stride]. Adding or removing entities of the cycle invalidates the iterators. size() and operator[] walk
+ * the cycle, which is short for the cycles of a surface mesh.
+ */
+template <typename T, unsigned int Stride>
+class TopologyCycle
+{
+private:
+    const std::vector<TopologyIndexType> *Next;
+    const std::vector<T *> *Objects;
+
+    /**
+     * @brief Last node of the cycle, or NoTopologyIndex if the cycle is empty
+     */
+    TopologyIndexType Last;
+
+public:
+    /**
+     * @brief Forward iterator over the cycle. Holds its own copy of the cycle, i.e. it stays valid when the range it
+     * was obtained from goes out of scope.
+     */
+    class Iterator
+    {
+    private:
+        const std::vector<TopologyIndexType> *Next;
+        const std::vector<T *> *Objects;
+        TopologyIndexType Last;
+        TopologyIndexType Node;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T *value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T *const *pointer;
+        typedef T *reference;
+
+        Iterator(const std::vector<TopologyIndexType> *Next, const std::vector<T *> *Objects, TopologyIndexType Last,
+                 TopologyIndexType Node)
+        {
+            this->Next = Next;
+            this->Objects = Objects;
+            this->Last = Last;
+            this->Node = Node;
+        }
+
+        T *operator*() const
+        { return (*this->Objects)[this->Node / Stride]; }
+
+        Iterator &operator++()
+        {
+            this->Node = (this->Node == this->Last) ? NoTopologyIndex : (*this->Next)[this->Node];
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator Previous = *this;
+            ++(*this);
+            return Previous;
+        }
+
+        bool operator==(const Iterator &Other) const
+        { return this->Node == Other.Node; }
+
+        bool operator!=(const Iterator &Other) const
+        { return this->Node != Other.Node; }
+    };
+
+    TopologyCycle(const std::vector<TopologyIndexType> *Next, const std::vector<T *> *Objects, TopologyIndexType Last)
+    {
+        this->Next = Next;
+        this->Objects = Objects;
+        this->Last = Last;
+    }
+
+    Iterator begin() const
+    {
+        TopologyIndexType First = (this->Last == NoTopologyIndex) ? NoTopologyIndex : (*this->Next)[this->Last];
+        return Iterator(this->Next, this->Objects, this->Last, First);
+    }
+
+    Iterator end() const
+    { return Iterator(this->Next, this->Objects, this->Last, NoTopologyIndex); }
+
+    bool empty() const
+    { return this->Last == NoTopologyIndex; }
+
+    size_t size() const
+    {
+        size_t Size = 0;
+        for (Iterator it = this->begin(); it != this->end(); ++it) {
+            Size++;
+        }
+        return Size;
+    }
+
+    T *operator[](size_t Index) const
+    {
+        Iterator it = this->begin();
+        for (size_t i = 0; i < Index; i++) {
+            ++it;
+        }
+        return *it;
+    }
+};
+
+/**
+ * @brief The MeshTopology class holds the coordinates and the connectivity of a triangle surface mesh as arrays of indices
+ * (a corner table), replacing lists of pointers on each entity.
+ *
+ * Coordinates are stored as structure of arrays, one array per direction, indexed by vertex. Each triangle t has three
+ * corners 3t, 3t+1 and 3t+2. Corner k holds a vertex and the half-edge from that vertex to the vertex of corner k+1
+ * (modulo 3). Each edge e has two ends 2e and 2e+1, each holding a vertex. Incidence is kept in circular singly linked
+ * cycles of indices:
+ * - the corner cycle of a vertex links the corners at the vertex, i.e. gives its triangles,
+ * - the disk cycle of a vertex links the edge ends at the vertex, i.e. gives its edges,
+ * - the radial cycle of an edge links the half-edges along the edge, i.e. gives its triangles. An edge may be shared by
+ *   any number of triangles, as where three or more interfaces meet.
+ * Each cycle is identified by its last node. New nodes are appended, and nodes are removed without changing the order
+ * of the other nodes, i.e. the cycles list entities in the order they were connected.
+ *
+ * Indices of removed edges and triangles are reused. Vertices are never removed. The EdgeType and TriangleType objects
+ * of the mesh are found through the indices.
+ */
+class MeshTopology
+{
+private:
+    /**
+     * @brief Last corner of the corner cycle of each vertex
+     */
+    std::vector<TopologyIndexType> VertexLastCorner;
+
+    /**
+     * @brief Last edge end of the disk cycle of each vertex
+     */
+    std::vector<TopologyIndexType> VertexLastEnd;
+
+    /**
+     * @brief Vertex of each edge end
+     */
+    std::vector<TopologyIndexType> EndVertex;
+
+    /**
+     * @brief Next edge end in the disk cycle of each edge end
+     */
+    std::vector<TopologyIndexType> NextEnd;
+
+    /**
+     * @brief Last half-edge of the radial cycle of each edge
+     */
+    std::vector<TopologyIndexType> EdgeLastHalfEdge;
+
+    /**
+     * @brief Edge object of each edge, NULL for removed edges
+     */
+    std::vector<EdgeType *> EdgeObjects;
+
+    /**
+     * @brief Indices of removed edges, available for reuse
+     */
+    std::vector<TopologyIndexType> FreeEdges;
+
+    /**
+     * @brief Vertex of each corner
+     */
+    std::vector<TopologyIndexType> CornerVertex;
+
+    /**
+     * @brief Next corner in the corner cycle of each corner
+     */
+    std::vector<TopologyIndexType> NextCorner;
+
+    /**
+     * @brief Edge of the half-edge of each corner
+     */
+    std::vector<TopologyIndexType> HalfEdgeEdge;
+
+    /**
+     * @brief Next half-edge in the radial cycle of each half-edge
+     */
+    std::vector<TopologyIndexType> NextHalfEdge;
+
+    /**
+     * @brief Triangle object of each triangle, NULL for removed triangles
+     */
+    std::vector<TriangleType *> TriangleObjects;
+
+    /**
+     * @brief Indices of removed triangles, available for reuse
+     */
+    std::vector<TopologyIndexType> FreeTriangles;
+
+    /**
+     * @brief Gives a new index of an array of Count items. Throws std::overflow_error if it does not fit in
+     * TopologyIndexType
+     */
+    static TopologyIndexType GiveNewIndex(size_t Count);
+
+public:
+    /**
+     * @brief Coordinates of the vertices, one array per direction
+     */
+    std::array<std::vector<double>, 3> Coordinates;
+
+    /**
+     * @brief Adds a vertex
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Index of the new vertex. Vertices are numbered in the order they are added.
+     */
+    TopologyIndexType AddVertex(double x, double y, double z);
+
+    /**
+     * @brief Gives the number of vertices
+     */
+    size_t GiveNumberOfVertices() const
+    { return this->Coordinates[0].size(); }
+
+    /**
+     * @brief Adds an edge between two vertices and appends it to their disk cycles
+     * @param v0 Vertex of end 0
+     * @param v1 Vertex of end 1
+     * @param Edge Edge object
+     * @return Index of the edge
+     */
+    TopologyIndexType AddEdge(TopologyIndexType v0, TopologyIndexType v1, EdgeType *Edge);
+
+    /**
+     * @brief Removes an edge from the disk cycles of its vertices. The radial cycle of the edge must be empty.
+     * @param e Edge
+     */
+    void RemoveEdge(TopologyIndexType e);
+
+    /**
+     * @brief Moves one end of an edge to another vertex. The edge is removed from the disk cycle of the old vertex and
+     * appended to the disk cycle of the new vertex.
+     * @param e Edge
+     * @param End End of the edge, 0 or 1
+     * @param v New vertex of the end
+     */
+    void MoveEdgeEnd(TopologyIndexType e, int End, TopologyIndexType v);
+
+    /**
+     * @brief Finds the edge between two vertices by walking the disk cycle of the first vertex
+     * @return Index of the first edge found, or NoTopologyIndex if there is none
+     */
+    TopologyIndexType FindEdge(TopologyIndexType v0, TopologyIndexType v1) const;
+
+    /**
+     * @brief Gives the vertex of an end of an edge
+     * @param e Edge
+     * @param End End of the edge, 0 or 1
+     */
+    TopologyIndexType GiveEdgeVertex(TopologyIndexType e, int End) const
+    { return this->EndVertex[2 * (size_t) e + End]; }
+
+    /**
+     * @brief Gives the edge object of an edge
+     */
+    EdgeType *GiveEdge(TopologyIndexType e) const
+    { return this->EdgeObjects[e]; }
+
+    /**
+     * @brief Adds a triangle. Its corners are appended to the corner cycles of its vertices and its half-edges to the
+     * radial cycles of its edges.
+     * @param Vertices Vertices of the corners
+     * @param Edges Edges of the half-edges, where half-edge k goes from corner k to corner k+1 (modulo 3)
+     * @param Triangle Triangle object
+     * @return Index of the triangle
+     */
+    TopologyIndexType AddTriangle(const std::array<TopologyIndexType, 3> &Vertices,
+                                  const std::array<TopologyIndexType, 3> &Edges, TriangleType *Triangle);
+
+    /**
+     * @brief Removes a triangle from the corner cycles of its vertices and the radial cycles of its edges
+     * @param t Triangle
+     */
+    void RemoveTriangle(TopologyIndexType t);
+
+    /**
+     * @brief Reverses the orientation of a triangle by exchanging corners 0 and 1, i.e. also half-edges 1 and 2. Each
+     * exchanged corner and half-edge takes the place of the other in the cycles, so the order of the cycles is kept.
+     * @param t Triangle
+     */
+    void FlipTriangle(TopologyIndexType t);
+
+    /**
+     * @brief Gives the vertex of a corner of a triangle
+     * @param t Triangle
+     * @param Corner Corner, 0, 1 or 2
+     */
+    TopologyIndexType GiveCornerVertex(TopologyIndexType t, int Corner) const
+    { return this->CornerVertex[3 * (size_t) t + Corner]; }
+
+    /**
+     * @brief Gives the edge of a half-edge of a triangle
+     * @param t Triangle
+     * @param Corner Corner where the half-edge starts, 0, 1 or 2
+     */
+    TopologyIndexType GiveHalfEdgeEdge(TopologyIndexType t, int Corner) const
+    { return this->HalfEdgeEdge[3 * (size_t) t + Corner]; }
+
+    /**
+     * @brief Gives the triangle object of a triangle
+     */
+    TriangleType *GiveTriangle(TopologyIndexType t) const
+    { return this->TriangleObjects[t]; }
+
+    /**
+     * @brief Gives the triangles of a vertex, i.e. its corner cycle
+     */
+    TopologyCycle<TriangleType, 3> GiveVertexTriangles(TopologyIndexType v) const
+    { return TopologyCycle<TriangleType, 3>(&this->NextCorner, &this->TriangleObjects, this->VertexLastCorner[v]); }
+
+    /**
+     * @brief Gives the edges of a vertex, i.e. its disk cycle
+     */
+    TopologyCycle<EdgeType, 2> GiveVertexEdges(TopologyIndexType v) const
+    { return TopologyCycle<EdgeType, 2>(&this->NextEnd, &this->EdgeObjects, this->VertexLastEnd[v]); }
+
+    /**
+     * @brief Gives the triangles of an edge, i.e. its radial cycle
+     */
+    TopologyCycle<TriangleType, 3> GiveEdgeTriangles(TopologyIndexType e) const
+    { return TopologyCycle<TriangleType, 3>(&this->NextHalfEdge, &this->TriangleObjects, this->EdgeLastHalfEdge[e]); }
+
+    /**
+     * @brief Checks that the cycles are consistent with the corners and ends they link. Stops with an error otherwise.
+     */
+    void DoSanityCheck() const;
+
+    /**
+     * @brief Gives the memory held by the arrays
+     * @return Number of bytes
+     */
+    size_t GiveMemoryUsage() const;
+};
+
+}
+
+#endif // MESHTOPOLOGY_H
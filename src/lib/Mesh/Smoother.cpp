@@ -13,7 +13,7 @@ std::vector<std::vector<VertexType *>> Smoother::GetConnectivityVector(std::vect
         if (!v->IsFixedVertex()) {
             // This will contain all connected vertices. Depending on type of v, some other vertices will be removed
 
-            for (EdgeType *e: v->Edges) {
+            for (EdgeType *e: v->GiveEdges()) {
                 if (!e->IsTransverse) {
                     for (VertexType *ve: e->Vertices) {
                         ConnectedVertices.push_back(ve);
@@ -72,7 +72,7 @@ Smoother::CheckPenetration(std::vector<VertexType *> *Vertices, MeshManipulation
     std::vector<TriangleType *> Triangles;
 
     for (VertexType *v : *Vertices) {
-        for (TriangleType *t : v->Triangles) {
+        for (TriangleType *t : v->GiveTriangles()) {
             Triangles.push_back(t);
         }
     }
@@ -89,13 +89,13 @@ Smoother::CheckPenetration(std::vector<VertexType *> *Vertices, MeshManipulation
                 if (Mesh->CheckTrianglePenetration(t1, t2)) {
                     //Mesh->CheckTrianglePenetration(t1, t2);
                     IntersectingTriangles.push_back({t1, t2});
-                    LOG("Triangles %u and %u intersect!\n", t1->ID, t2->ID);
-                    LOG("t1(%u): (%f, %f, %f), (%f, %f, %f), (%f, %f, %f)\n", t1->ID, t1->Vertices.at(0)->get_c(0),
-                        t1->Vertices.at(0)->get_c(1), t1->Vertices.at(0)->get_c(2),
+                    LOG("Triangles %lld and %lld intersect!\n", (long long) t1->ID, (long long) t2->ID);
+                    LOG("t1(%lld): (%f, %f, %f), (%f, %f, %f), (%f, %f, %f)\n", (long long) t1->ID,
+                        t1->Vertices.at(0)->get_c(0), t1->Vertices.at(0)->get_c(1), t1->Vertices.at(0)->get_c(2),
                         t1->Vertices.at(1)->get_c(0), t1->Vertices.at(1)->get_c(1), t1->Vertices.at(1)->get_c(2),
                         t1->Vertices.at(2)->get_c(0), t1->Vertices.at(2)->get_c(1), t1->Vertices.at(2)->get_c(2));
-                    LOG("t2(%u): (%f, %f, %f), (%f, %f, %f), (%f, %f, %f)\n", t2->ID, t2->Vertices.at(0)->get_c(0),
-                        t2->Vertices.at(0)->get_c(1), t2->Vertices.at(0)->get_c(2),
+                    LOG("t2(%lld): (%f, %f, %f), (%f, %f, %f), (%f, %f, %f)\n", (long long) t2->ID,
+                        t2->Vertices.at(0)->get_c(0), t2->Vertices.at(0)->get_c(1), t2->Vertices.at(0)->get_c(2),
                         t2->Vertices.at(1)->get_c(0), t2->Vertices.at(1)->get_c(1), t2->Vertices.at(1)->get_c(2),
                         t2->Vertices.at(2)->get_c(0), t2->Vertices.at(2)->get_c(1), t2->Vertices.at(2)->get_c(2));
                 }
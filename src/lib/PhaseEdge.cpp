@@ -8,19 +8,34 @@ PhaseEdge::PhaseEdge(Options *Opt, Smoother *EdgeSmoother)
     this->EdgeSmoother = EdgeSmoother;
 }
 
-std::vector<VertexType *> PhaseEdge::GetFlatListOfVertices()
+const std::vector<VertexType *> &PhaseEdge::GetFlatListOfVertices()
 {
-    // TODO: If we assume that the lists are ordered, this can be optimized
-    std::vector<VertexType *> FlatList;
+    if (this->FlatListOfVertices.empty()) {
+        for (auto &e : this->EdgeSegments) {
+            this->FlatListOfVertices.push_back(e[0]);
+            this->FlatListOfVertices.push_back(e[1]);
+        }
+
+        // Uniquify
+        this->FlatListOfVertices.erase(std::unique(this->FlatListOfVertices.begin(), this->FlatListOfVertices.end()),
+                                       this->FlatListOfVertices.end());
+    }
+    return this->FlatListOfVertices;
+}
 
-    for (auto e : this->EdgeSegments) {
-        FlatList.push_back(e.at(0));
-        FlatList.push_back(e.at(1));
+const std::vector<VertexType *> &PhaseEdge::GiveSortedListOfVertices()
+{
+    if (this->SortedListOfVertices.empty()) {
+        this->SortedListOfVertices = this->GetFlatListOfVertices();
+        std::sort(this->SortedListOfVertices.begin(), this->SortedListOfVertices.end());
     }
+    return this->SortedListOfVertices;
+}
 
-    // Uniquify
-    FlatList.erase(std::unique(FlatList.begin(), FlatList.end()), FlatList.end());
-    return FlatList;
+void PhaseEdge::InvalidateVertexLists()
+{
+    this->FlatListOfVertices.clear();
+    this->SortedListOfVertices.clear();
 }
 
 std::vector<VertexType *> PhaseEdge::GiveVerticesConnectedToVertex(VertexType *v)
@@ -39,94 +54,98 @@ std::vector<VertexType *> PhaseEdge::GiveVerticesConnectedToVertex(VertexType *v
 
 void PhaseEdge::SortAndFixBrokenEdge(std::vector<PhaseEdge *> *FixedEdges)
 {
-    // For each EdgeSegment find the two connecting segments until all segments has been processed. If links
-    // to the end vertices of a chain of segments cannot be found while there are segments in the list, a new
-    // list of segments is created.
+    // Each chain of segments starts with the first segment not yet used. The chain is extended at both ends by
+    // repeatedly adding the first unused segment (in the order of EdgeSegments) containing the vertex at the end. When
+    // no such segment exists for either end, the chain is complete and a new chain is started.
+    //
+    // The segments containing a vertex are found in a list of (vertex, segment) pairs sorted by vertex, which makes
+    // this linear in the number of segments apart from the sorting.
 
     FixedEdges->clear();
 
-    while (this->EdgeSegments.size() > 0) {
-        std::array<VertexType *, 2> ThisLink = this->EdgeSegments.at(0);
-        this->EdgeSegments.erase(this->EdgeSegments.begin(), this->EdgeSegments.begin() + 1);
+    size_t NumberOfSegments = this->EdgeSegments.size();
+
+    std::vector<std::pair<VertexType *, size_t> > SegmentsByVertex;
+    SegmentsByVertex.reserve(2 * NumberOfSegments);
+    for (size_t j = 0; j < NumberOfSegments; j++) {
+        SegmentsByVertex.push_back({this->EdgeSegments[j][0], j});
+        SegmentsByVertex.push_back({this->EdgeSegments[j][1], j});
+    }
+    std::sort(SegmentsByVertex.begin(), SegmentsByVertex.end());
+
+    std::vector<bool> Used(NumberOfSegments, false);
+
+    // Gives the first unused segment containing v, or NumberOfSegments if all are used
+    auto FindNextLink = [&](VertexType *v) -> size_t {
+        auto it = std::lower_bound(SegmentsByVertex.begin(), SegmentsByVertex.end(),
+                                   std::pair<VertexType *, size_t>(v, 0));
+        for (; (it != SegmentsByVertex.end()) && (it->first == v); it++) {
+            if (!Used[it->second]) {
+                return it->second;
+            }
+        }
+        return NumberOfSegments;
+    };
+
+    size_t FirstUnused = 0;
+    while (true) {
+        while ((FirstUnused < NumberOfSegments) && Used[FirstUnused]) {
+            FirstUnused++;
+        }
+        if (FirstUnused == NumberOfSegments) {
+            break;
+        }
 
-        LOG("Find connections for vertices (%u, %u)\n", ThisLink.at(0)->ID, ThisLink.at(1)->ID);
+        std::array<VertexType *, 2> ThisLink = this->EdgeSegments[FirstUnused];
+        Used[FirstUnused] = true;
+
+        LOG("Find connections for vertices (%lld, %lld)\n", (long long) ThisLink.at(0)->ID,
+            (long long) ThisLink.at(1)->ID);
 
         PhaseEdge *NewPhaseEdge = new PhaseEdge(this->Opt, this->EdgeSmoother);
         NewPhaseEdge->Phases = this->Phases;
-        NewPhaseEdge->EdgeSegments.push_back(ThisLink);
         FixedEdges->push_back(NewPhaseEdge);
 
+        // Segments found before (i=0) and after (i=1) ThisLink, in the order they are found
+        std::vector<std::array<VertexType *, 2> > Links[2];
+
         // Find next link, i.e. the link containing the i:th vertex of the current segment
         for (int i = 0; i < 2; i++) {
             VertexType *VertexToFind = ThisLink.at(i);
 
-            bool LastConnectionFound = false;
-            while (!LastConnectionFound) {
-                // Remove self from list of PhaseEdges
-
-                std::array<VertexType *, 2> NextLink;
-                bool NextLinkFound = false;
-                for (unsigned int j = 0; j < this->EdgeSegments.size(); j++) {
-                    if ((this->EdgeSegments.at(j).at(0) == VertexToFind) |
-                        (this->EdgeSegments.at(j).at(1) == VertexToFind)) {
-                        LOG("Next link found (%p, %p)\n", this->EdgeSegments.at(j).at(0),
-                            this->EdgeSegments.at(j).at(1));
-
-                        NextLink = this->EdgeSegments.at(j);
-                        NextLinkFound = true;
-                        this->EdgeSegments.erase(this->EdgeSegments.begin() + j, this->EdgeSegments.begin() + j + 1);
-                        break;
-                    }
-                }
+            size_t j;
+            while ((j = FindNextLink(VertexToFind)) < NumberOfSegments) {
+                std::array<VertexType *, 2> &NextLink = this->EdgeSegments[j];
+                LOG("Next link found (%p, %p)\n", NextLink[0], NextLink[1]);
+                Used[j] = true;
 
-                if (NextLinkFound) {
-                    std::array<VertexType *, 2> *NewEdgeSegment;
-                    VertexType *NextLastVertex;
-
-                    if (NextLink.at(0) == VertexToFind) {
-                        NextLastVertex = NextLink.at(1);
-                    } else {
-                        NextLastVertex = NextLink.at(0);
-                    }
-
-                    if (i == 0) {
-                        NewEdgeSegment = new std::array<VertexType *, 2>{{
-                                                                                 NextLastVertex, VertexToFind
-                                                                         }};
-                        NewPhaseEdge->EdgeSegments.insert(NewPhaseEdge->EdgeSegments.begin(), *NewEdgeSegment);
-                    } else {
-                        NewEdgeSegment = new std::array<VertexType *, 2>{{
-                                                                                 VertexToFind, NextLastVertex
-                                                                         }};
-                        NewPhaseEdge->EdgeSegments.push_back(*NewEdgeSegment);
-                    }
-
-                    VertexToFind = NextLastVertex;
+                VertexType *NextLastVertex = (NextLink[0] == VertexToFind) ? NextLink[1] : NextLink[0];
+
+                if (i == 0) {
+                    Links[i].push_back({{NextLastVertex, VertexToFind}});
                 } else {
-                    LOG("No more connections found for i=%u\n", i);
-                    LastConnectionFound = true;
+                    Links[i].push_back({{VertexToFind, NextLastVertex}});
                 }
-            }
 
-            // Remove reference to old phase edge and add reference to new
-            std::vector<VertexType *> Vertices = NewPhaseEdge->GetFlatListOfVertices();
-
-            for (VertexType *v: Vertices) {
-                v->PhaseEdges.erase(std::remove(v->PhaseEdges.begin(), v->PhaseEdges.end(), this), v->PhaseEdges.end());
-                v->PhaseEdges.push_back(NewPhaseEdge);
-            }
-
-            // If no EdgeSegments are left, exit
-            if (this->EdgeSegments.size() == 0) {
-                break;
+                VertexToFind = NextLastVertex;
             }
+            LOG("No more connections found for i=%u\n", i);
         }
-        if (this->EdgeSegments.size() > 0) {
-            LOG("Items left, split\n", 0);
-        } else {
-            LOG("No items left. \n", 0);
+
+        NewPhaseEdge->EdgeSegments.reserve(Links[0].size() + 1 + Links[1].size());
+        NewPhaseEdge->EdgeSegments.assign(Links[0].rbegin(), Links[0].rend());
+        NewPhaseEdge->EdgeSegments.push_back(ThisLink);
+        NewPhaseEdge->EdgeSegments.insert(NewPhaseEdge->EdgeSegments.end(), Links[1].begin(), Links[1].end());
+
+        // Remove reference to old phase edge and add reference to new
+        for (VertexType *v : NewPhaseEdge->GetFlatListOfVertices()) {
+            v->PhaseEdges.erase(std::remove(v->PhaseEdges.begin(), v->PhaseEdges.end(), this), v->PhaseEdges.end());
+            v->PhaseEdges.push_back(NewPhaseEdge);
         }
     }
+
+    this->EdgeSegments.clear();
+    this->InvalidateVertexLists();
 }
 
 bool PhaseEdge::IsClosed()
@@ -146,7 +165,7 @@ void PhaseEdge::GiveTopologyLists(std::vector<std::vector<VertexType *> > *Conne
         this->FixedVertices.push_back(this->EdgeSegments.at(this->EdgeSegments.size() - 1).at(1));
     }
 
-    std::vector<VertexType *> FlatList = this->GetFlatListOfVertices();
+    const std::vector<VertexType *> &FlatList = this->GetFlatListOfVertices();
     bool closed = this->IsClosed();
 
     // Build connection matrix
@@ -204,6 +223,7 @@ void PhaseEdge::Smooth(MeshData *Mesh)
 void PhaseEdge::AddPhaseEdgeSegment(VertexType *v1, VertexType *v2)
 {
     EdgeSegments.push_back({{v1, v2}});
+    this->InvalidateVertexLists();
 }
 
 void PhaseEdge::LogPhaseEdge()
@@ -39,10 +39,21 @@ private:
      */
     std::vector<VertexType *> FixedVertices;
 
+    /**
+     * @brief Cache of GetFlatListOfVertices. Empty if not computed since EdgeSegments last changed.
+     */
+    std::vector<VertexType *> FlatListOfVertices;
+
+    /**
+     * @brief Cache of GiveSortedListOfVertices. Empty if not computed since EdgeSegments last changed.
+     */
+    std::vector<VertexType *> SortedListOfVertices;
+
 public:
 
     /**
-     * @brief EdgeSegments hold all edge segments for this edge
+     * @brief EdgeSegments hold all edge segments for this edge. If changed from outside the class,
+     * InvalidateVertexLists must be called.
      */
     std::vector<std::array<VertexType *, 2> > EdgeSegments;
 
@@ -103,10 +114,23 @@ public:
     bool IsClosed();
 
     /**
-     * @brief Returns a list of all vertices in the order they appear on the PhaseEdge.
+     * @brief Returns a list of all vertices in the order they appear on the PhaseEdge. The list is computed once and
+     * kept until the edge changes.
      * @return List of vertices
      */
-    std::vector<VertexType *> GetFlatListOfVertices();
+    const std::vector<VertexType *> &GetFlatListOfVertices();
+
+    /**
+     * @brief Returns the list given by GetFlatListOfVertices sorted by address. The list is computed once and kept
+     * until the edge changes.
+     * @return List of vertices
+     */
+    const std::vector<VertexType *> &GiveSortedListOfVertices();
+
+    /**
+     * @brief Discards the cached lists of vertices. Called whenever EdgeSegments changes.
+     */
+    void InvalidateVertexLists();
 
     /**
      * @brief List of all phase IDs ni contact with this phase edge
@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <vector>
+#include <cmath>
 #include <iterator>
 #include <time.h>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include "Voxel2Tet.h"
 #include "Importer.h"
@@ -12,6 +14,7 @@
 #include "TetGenCaller.h"
 #include "SpringSmoother.h"
 #include "SpringSmootherPenalty.h"
+#include "Parallel.h"
 
 namespace voxel2tet
 {
@@ -109,6 +112,10 @@ void Voxel2TetClass::PrintHelp()
     printf("\n\t\t\tOnly consider the subset of the input contained within the boundingbox defined by arg. Here, arg=\"[xmin ymin zmin xmax ymax zmax]\" (include citations and brackets)");
     printf("\n\t\t-treatzeroasvoid");
     printf("\n\t\t\tTreats a material with ID 0 as void. By default, this is considered a solid.");
+    printf("\n\t\t-bricklayout");
+    printf("\n\t\t\tStore the voxel data in bricks of %i^3 voxels in Z-order instead of row by row. Faster on large inputs.", LabelGridBase::BrickSize);
+    printf("\n\t\t-cachecallback");
+    printf("\n\t\t\tWhen the geometry is given by a callback function, evaluate it once per voxel in parallel and cache the result. The callback function must be thread-safe.");
     printf("\n\t\t-nocoarsening");
     printf("\n\t\t\tSkip coarsening step.");
     printf("\n\t\t-spring_c value");
@@ -151,11 +158,26 @@ void Voxel2TetClass::PrintHelp()
 }
 
 void Voxel2TetClass::LoadCallback(cbMaterialIDByCoordinate MaterialIDByCoordinate, std::array<double, 3> origin,
-                                  std::array<double, 3> spacing, std::array<int, 3> dimensions)
+                                  std::array<double, 3> spacing, std::array<int, 3> dimensions, bool CacheMaterialIDs)
 {
     STATUS("Setup callback functions\n", 0);
     CallbackImporter *DataReader = new CallbackImporter(MaterialIDByCoordinate, origin, spacing, dimensions);
     this->Imp = DataReader;
+    this->ApplyLabelLayoutOption();
+    if (CacheMaterialIDs || this->Opt->has_key("cachecallback")) {
+        DataReader->SampleVoxels();
+    }
+    FinalizeLoad();
+}
+
+void Voxel2TetClass::LoadCallback(cbMaterialIDsBySlab MaterialIDsBySlab, std::array<double, 3> origin,
+                                  std::array<double, 3> spacing, std::array<int, 3> dimensions)
+{
+    STATUS("Setup batch callback functions\n", 0);
+    CallbackImporter *DataReader = new CallbackImporter(MaterialIDsBySlab, origin, spacing, dimensions);
+    this->Imp = DataReader;
+    this->ApplyLabelLayoutOption();
+    DataReader->SampleVoxels();
     FinalizeLoad();
 }
 
@@ -172,10 +194,10 @@ void Voxel2TetClass::LoadFile(std::string Filename)
 	if ((strcasecmp(ext, "dream3d") == 0) | (strcasecmp(ext, "hdf5") == 0)) {
         Import = new Dream3DDataReader(this->Opt->GiveStringValue("DataContainer"),
                                        this->Opt->GiveStringValue("MaterialId"));
-        Import->LoadFile(Filename);
     } else if (strcasecmp(ext, "vtk") == 0) {
         Import = new VTKStructuredReader();
-        Import->LoadFile(Filename);
+    } else if ((strcasecmp(ext, "nrrd") == 0) | (strcasecmp(ext, "nhdr") == 0)) {
+        Import = new NRRDReader();
     } else {
         STATUS("File extension %s not recognized\n", ext);
         exit(-1);
@@ -183,7 +205,17 @@ void Voxel2TetClass::LoadFile(std::string Filename)
 
     this->Imp = Import;
 
-    // If specified, use cut-out argument
+    // If specified, use cut-out argument. This is set before loading to allow importers to only read the cut-out.
+    this->ApplyCutOutOption();
+    this->ApplyLabelLayoutOption();
+
+    this->Imp->LoadFile(Filename);
+
+    FinalizeLoad();
+}
+
+void Voxel2TetClass::ApplyCutOutOption()
+{
     if (this->Opt->has_key("voxelcutout")) {
         std::vector<int> VoxelCutOut = this->Opt->GiveIntegerList("voxelcutout");
         if (VoxelCutOut.size() != 6) {
@@ -198,8 +230,13 @@ void Voxel2TetClass::LoadFile(std::string Filename)
         this->Imp->CutOut.maxvalues[1] = VoxelCutOut[4];
         this->Imp->CutOut.maxvalues[2] = VoxelCutOut[5];
     }
+}
 
-    FinalizeLoad();
+void Voxel2TetClass::ApplyLabelLayoutOption()
+{
+    if (this->Opt->has_key("bricklayout")) {
+        this->Imp->LabelLayout = LL_BRICKED;
+    }
 }
 
 void Voxel2TetClass::FinalizeLoad()
@@ -211,7 +248,7 @@ void Voxel2TetClass::FinalizeLoad()
     this->Imp->GiveDimensions(dim);
 
     STATUS("\tVoxel dimensions are %f * %f * %f\n", cellspace[0], cellspace[1], cellspace[2]);
-    STATUS("\tNumber of voxels are %u * %u * %u = %u\n", dim[0], dim[1], dim[2], dim[0] * dim[1] * dim[2]);
+    STATUS("\tNumber of voxels are %u * %u * %u = %zu\n", dim[0], dim[1], dim[2], (size_t) dim[0] * dim[1] * dim[2]);
 
     this->EdgeSmoother = 0;
 
@@ -364,7 +401,14 @@ void Voxel2TetClass::Tetrahedralize()
 
         t->MaterialID = Tetgen2Self[t->MaterialID];
     }
-    free(this->Mesh);
+
+    std::ostringstream SurfaceMeshStatistics;
+    this->Mesh->WriteAllocationStatistics(SurfaceMeshStatistics);
+    this->SurfaceMeshAllocations = SurfaceMeshStatistics.str();
+
+    // Surfaces, PhaseEdges and Volumes refer to entities of the surface mesh and are not used past this point, except
+    // for being deleted in the destructor, which does not dereference the mesh entities they hold.
+    delete this->Mesh;
 
     this->Mesh = NewMesh;
 
@@ -378,10 +422,217 @@ void Voxel2TetClass::ExportVolume(std::string FileName, Exporter_FileTypes FileT
     this->Mesh->ExportVolume(FileName, FileType);
 }
 
-void Voxel2TetClass::FindSurfaces()
+/**
+ * @brief Directions to neighbouring voxels, in the order used by VoxelFaceType::Direction
+ */
+static const int VoxelFaceDirections[6][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {-1, 0, 0}, {0, -1, 0}, {0, 0, -1}};
+
+/**
+ * @brief Indices of the coordinates spanning the face in each direction
+ */
+static const int VoxelFaceSpan[6][2] = {{1, 2}, {2, 0}, {0, 1}, {1, 2}, {2, 0}, {0, 1}};
+
+/**
+ * @brief Returns the label of material 0 if it exists and is treated as void, and otherwise a label not in the grid
+ */
+static size_t GiveVoidLabel(LabelGridBase *Labels, bool TreatZeroAsVoid)
 {
+    size_t NumberOfLabels = Labels->GiveNumberOfLabels();
+    size_t VoidLabel = NumberOfLabels + 6;
+    for (size_t l = 0; l < NumberOfLabels; l++) {
+        if (TreatZeroAsVoid && (Labels->GiveOriginalID(l) == 0)) {
+            VoidLabel = l;
+        }
+    }
+    return VoidLabel;
+}
 
-    STATUS("\tFind surfaces\n", 0);
+/**
+ * @brief Adds the faces between voxel (i, j, k) and its neighbours of other materials to Faces
+ * @param Labels Label grid
+ * @param Indices Indices of voxel
+ * @param ThisLabel Label of voxel
+ * @param Neighbours Labels of the neighbours in the directions of VoxelFaceDirections
+ * @param VoidLabel Label treated as void, cf. GiveVoidLabel
+ * @param Faces List of faces
+ */
+template <typename T>
+static inline void AddVoxelFaces(LabelGridBase *Labels, int i, int j, int k, T ThisLabel, const T Neighbours[6],
+                                 size_t VoidLabel, std::vector<VoxelFaceType> &Faces)
+{
+    if ((Neighbours[0] == ThisLabel) & (Neighbours[1] == ThisLabel) & (Neighbours[2] == ThisLabel) &
+        (Neighbours[3] == ThisLabel) & (Neighbours[4] == ThisLabel) & (Neighbours[5] == ThisLabel)) {
+        return;
+    }
+
+    for (int m = 0; m < 6; m++) {
+        T NeighbourLabel = Neighbours[m];
+        if (NeighbourLabel == ThisLabel) {
+            continue;
+        }
+        // If we are comparing with the outside, take into account that a we might have void (i.e. 0) in both voxels
+        if ((ThisLabel == VoidLabel) && Labels->IsOutside(NeighbourLabel)) {
+            continue;
+        }
+        VoxelFaceType Face;
+        Face.Indices[0] = i;
+        Face.Indices[1] = j;
+        Face.Indices[2] = k;
+        Face.Direction = m;
+        Face.ThisPhase = Labels->GiveOriginalID(ThisLabel);
+        Face.NeighboringPhase = Labels->GiveOriginalID(NeighbourLabel);
+        Faces.push_back(Face);
+    }
+}
+
+template <typename T>
+void Voxel2TetClass::FindVoxelFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn,
+                                    std::vector<VoxelFaceType> &Faces)
+{
+    const T *L = Labels->GiveLabels<T>();
+    const size_t *Strides = Labels->GiveStrides();
+    const int *dim = Labels->GiveDimensions();
+    size_t VoidLabel = GiveVoidLabel(Labels, this->TreatZeroAsVoid);
+
+    // The faces are to be ordered by i first, while i is the index varying fastest in memory. Thus, scan blocks of
+    // consecutive i and collect the faces of each i in a separate bucket which is appended to Faces after the block.
+    const int BlockSize = 64;
+    std::vector<std::vector<VoxelFaceType> > Buckets(BlockSize);
+
+    for (int i0 = FirstColumn; i0 < LastColumn; i0 += BlockSize) {
+        int i1 = std::min(i0 + BlockSize, LastColumn);
+        for (int j = 0; j < dim[1]; j++) {
+            for (int k = 0; k < dim[2]; k++) {
+                size_t RowIndex = Labels->GiveIndex(0, j, k);
+                int BrickEnd = i0;
+                for (int i = i0; i < i1; i++) {
+                    if (i == BrickEnd) {
+                        // Voxels of uniform bricks have no faces. Skip to the end of the brick.
+                        BrickEnd = std::min(i1, ((i >> LabelGridBase::BrickShift) + 1) << LabelGridBase::BrickShift);
+                        if (Labels->IsInUniformBrick(i, j, k)) {
+                            i = BrickEnd - 1;
+                            continue;
+                        }
+                    }
+                    size_t index = RowIndex + i;
+                    T ThisLabel = L[index];
+
+                    // Only look in negative directions on the boundary. Other faces are found from the neighbouring voxel.
+                    T Neighbours[6] = {L[index + Strides[0]], L[index + Strides[1]], L[index + Strides[2]],
+                                       (i == 0) ? L[index - Strides[0]] : ThisLabel,
+                                       (j == 0) ? L[index - Strides[1]] : ThisLabel,
+                                       (k == 0) ? L[index - Strides[2]] : ThisLabel};
+
+                    AddVoxelFaces(Labels, i, j, k, ThisLabel, Neighbours, VoidLabel, Buckets[i - i0]);
+                }
+            }
+        }
+
+        for (int i = i0; i < i1; i++) {
+            Faces.insert(Faces.end(), Buckets[i - i0].begin(), Buckets[i - i0].end());
+            Buckets[i - i0].clear();
+        }
+    }
+}
+
+template <typename T>
+void Voxel2TetClass::FindBrickedVoxelFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn,
+                                           std::vector<VoxelFaceType> &Faces)
+{
+    const T *L = Labels->GiveLabels<T>();
+    const size_t *Strides = Labels->GiveStrides();
+    const int *dim = Labels->GiveDimensions();
+    size_t VoidLabel = GiveVoidLabel(Labels, this->TreatZeroAsVoid);
+    const int BrickSize = LabelGridBase::BrickSize;
+    const int BrickMask = BrickSize - 1;
+
+    // Scan one column of bricks (constant i range) at a time, brick by brick. Within a column, each (i, j) gets its
+    // own bucket of faces. Since the bricks are visited in increasing k, the faces of a bucket are ordered by k and
+    // the buckets can be appended to Faces in order of i and j after the column.
+    std::vector<std::vector<VoxelFaceType> > Buckets((size_t) BrickSize * dim[1]);
+
+    int i1;
+    for (int i0 = FirstColumn; i0 < LastColumn; i0 = i1) {
+        i1 = std::min(LastColumn, ((i0 >> LabelGridBase::BrickShift) + 1) << LabelGridBase::BrickShift);
+        for (int j0 = 0; j0 < dim[1]; j0 += BrickSize) {
+            int j1 = std::min(j0 + BrickSize, dim[1]);
+            for (int k0 = 0; k0 < dim[2]; k0 += BrickSize) {
+                int k1 = std::min(k0 + BrickSize, dim[2]);
+
+                // Voxels of uniform bricks have no faces
+                if (Labels->IsInUniformBrick(i0, j0, k0)) {
+                    continue;
+                }
+
+                // Offsets from a voxel on the far side of the brick to its neighbour in the next brick
+                size_t BrickIndex = Labels->GiveIndex(i0, j0, k0);
+                size_t CrossOffset[3] = {
+                    Labels->GiveIndex(i1, j0, k0) - BrickIndex - (i1 - 1 - i0) * Strides[0],
+                    Labels->GiveIndex(i0, std::min(j0 + BrickSize, dim[1]), k0) - BrickIndex - (BrickSize - 1) * Strides[1],
+                    Labels->GiveIndex(i0, j0, std::min(k0 + BrickSize, dim[2])) - BrickIndex - (BrickSize - 1) * Strides[2]};
+
+                for (int k = k0; k < k1; k++) {
+                    size_t kOffset = ((k & BrickMask) != BrickMask) ? Strides[2] : CrossOffset[2];
+                    for (int j = j0; j < j1; j++) {
+                        size_t jOffset = ((j & BrickMask) != BrickMask) ? Strides[1] : CrossOffset[1];
+                        size_t RowIndex = Labels->GiveIndex(i0, j, k);
+                        std::vector<VoxelFaceType> *Bucket = &Buckets[j];
+                        for (int i = i0; i < i1; i++, Bucket += dim[1]) {
+                            size_t index = RowIndex + (i - i0);
+                            T ThisLabel = L[index];
+
+                            // Only look in negative directions on the boundary. Other faces are found from the
+                            // neighbouring voxel.
+                            T Neighbours[6] = {L[index + (((i & BrickMask) != BrickMask) ? Strides[0] : CrossOffset[0])],
+                                               L[index + jOffset], L[index + kOffset],
+                                               (i == 0) ? L[Labels->GiveIndex(i - 1, j, k)] : ThisLabel,
+                                               (j == 0) ? L[Labels->GiveIndex(i, j - 1, k)] : ThisLabel,
+                                               (k == 0) ? L[Labels->GiveIndex(i, j, k - 1)] : ThisLabel};
+
+                            AddVoxelFaces(Labels, i, j, k, ThisLabel, Neighbours, VoidLabel, *Bucket);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<VoxelFaceType> *Bucket = &Buckets[0];
+        for (int i = i0; i < i1; i++) {
+            for (int j = 0; j < dim[1]; j++, Bucket++) {
+                Faces.insert(Faces.end(), Bucket->begin(), Bucket->end());
+                Bucket->clear();
+            }
+        }
+    }
+}
+
+void Voxel2TetClass::FindSlabFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn, VoxelSlabType &Slab)
+{
+    // Dispatch on layout and label width
+    bool Bricked = (Labels->GiveLayout() == LL_BRICKED);
+    switch (Labels->GiveBytesPerLabel()) {
+    case 1:
+        if (Bricked) {
+            this->FindBrickedVoxelFaces<uint8_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        } else {
+            this->FindVoxelFaces<uint8_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        }
+        break;
+    case 2:
+        if (Bricked) {
+            this->FindBrickedVoxelFaces<uint16_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        } else {
+            this->FindVoxelFaces<uint16_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        }
+        break;
+    default:
+        if (Bricked) {
+            this->FindBrickedVoxelFaces<uint32_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        } else {
+            this->FindVoxelFaces<uint32_t>(Labels, FirstColumn, LastColumn, Slab.Faces);
+        }
+        break;
+    }
 
     int dim[3];
     double spacing[3], origin[3];
@@ -389,119 +640,195 @@ void Voxel2TetClass::FindSurfaces()
     this->Imp->GiveSpacing(spacing);
     this->Imp->GiveOrigin(origin);
 
-    STATUS("\tTotal volume: %f\n", dim[0] * spacing[0] * dim[1] * spacing[1] * dim[2] * spacing[2]);
-
-    std::vector<double> signs = {
+    double signs[2] = {
         1, -1
     };
 
+    // Corners are identified by their indices in the lattice of voxel corners. Map them to indices in Slab.Corners.
+    LatticeVertexMap CornerIndices;
+    CornerIndices.Initialize(dim, Slab.Faces.size());
+    Slab.FaceCorners.reserve(Slab.Faces.size() * 4);
+
+    for (VoxelFaceType &Face : Slab.Faces) {
+        const int *direction = VoxelFaceDirections[Face.Direction];
+        const int *vindex = VoxelFaceSpan[Face.Direction];
+
+        // Compute centre off square
+        double c[3];
+        int CentreLattice[3];
+        for (int d = 0; d < 3; d++) {
+            c[d] = (double(Face.Indices[d]) + double(direction[d]) / 2.0) * spacing[d] + origin[d] + spacing[d] / 2.0;
+            CentreLattice[d] = Face.Indices[d] + (direction[d] > 0 ? 1 : 0);
+        }
 
-    for (int i = 0; i < dim[0]; i++) {
-        for (int j = 0; j < dim[1]; j++) {
-            for (int k = 0; k < dim[2]; k++) {
-                // Specifies directions in which we will look for different materials
-                std::vector<std::vector<double> > testdirections = {{1, 0, 0},
-                                                                    {0, 1, 0},
-                                                                    {0, 0, 1}};
-                // If we the adjacent material is of other type, we will create a square by varying the coordinates marked '1' in vdirections
-                std::vector<std::vector<double> > vdirections = {{0, 1, 1},
-                                                                 {1, 0, 1},
-                                                                 {1, 1, 0}};
-                // vindex is the indices of the coordinates
-                std::vector<std::vector<int> > vindex = {{1, 2},
-                                                         {2, 0},
-                                                         {0, 1}};
-
-                // If we are on a boundary, we need to check what is outside of that boundary
-                if (i == 0) {
-                    testdirections.push_back({-1, 0, 0});
-                    vdirections.push_back({0, 1, 1});
-                    vindex.push_back({1, 2});
-                }
-                if (j == 0) {
-                    testdirections.push_back({0, -1, 0});
-                    vdirections.push_back({1, 0, 1});
-                    vindex.push_back({2, 0});
-                }
-                if (k == 0) {
-                    testdirections.push_back({0, 0, -1});
-                    vdirections.push_back({1, 1, 0});
-                    vindex.push_back({0, 1});
+        for (double s1 : signs) {
+            for (double s2 : signs) {
+                int Lattice[3] = {CentreLattice[0], CentreLattice[1], CentreLattice[2]};
+                Lattice[vindex[0]] += (s1 > 0) ? 1 : 0;
+                Lattice[vindex[1]] += (s2 > 0) ? 1 : 0;
+                uint64_t Key = CornerIndices.GiveKey(Lattice[0], Lattice[1], Lattice[2]);
+
+                std::pair<IDType, bool> Inserted = CornerIndices.Insert(Key, (IDType) Slab.Corners.size());
+                if (Inserted.second) {
+                    // Compute coordinate of corner point
+                    std::array<double, 3> newvertex = {{c[0], c[1], c[2]}};
+                    newvertex[vindex[0]] = newvertex[vindex[0]] + s1 * spacing[vindex[0]] / 2.0;
+                    newvertex[vindex[1]] = newvertex[vindex[1]] + s2 * spacing[vindex[1]] / 2.0;
+                    Slab.Corners.push_back(newvertex);
+                    Slab.CornerKeys.push_back(Key);
                 }
+                Slab.FaceCorners.push_back((size_t) Inserted.first);
+            }
+        }
+    }
+}
 
-                int ThisPhase = this->Imp->GiveMaterialIDByIndex(i, j, k);
-                int NeighboringPhase;
-                bool SamePhase;
-
-                // Check material in each direction
-
-                for (unsigned int m = 0; m < testdirections.size(); m++) {
-                    int testi = testdirections.at(m).at(0) + i;
-                    int testj = testdirections.at(m).at(1) + j;
-                    int testk = testdirections.at(m).at(2) + k;
-
-                    // If comparing inside the domain, simply compare
-                    if ((testi >= 0) & (testj >= 0) & (testk >= 0) & (testi < dim[0]) & (testj < dim[1]) &
-                            (testk < dim[2])) {
-                        NeighboringPhase = this->Imp->GiveMaterialIDByIndex(testi, testj, testk);
-                        SamePhase = (ThisPhase == NeighboringPhase);
-                    } else {
-                        // If we are comparing with the outside, take into account that a we might have void (i.e. 0) in both voxels
-                        if ((ThisPhase == 0) & (TreatZeroAsVoid)) {
-                            // Void-to-void connection
-                            SamePhase = true;
-                            NeighboringPhase = ThisPhase;
-                        } else {
-                            SamePhase = false;
-                            NeighboringPhase = this->Imp->GiveMaterialIDByIndex(testi, testj, testk);
-                        }
-                    }
+void Voxel2TetClass::FindSurfaces()
+{
 
-                    if (!SamePhase) {   // Add surface. I.e. a square separating the two voxels
-                        // Compute centre off square
-                        double c[3];
-                        c[0] = (double(i) + double(testdirections.at(m).at(0)) / 2.0) * spacing[0] + origin[0] +
-                                spacing[0] / 2.0;
-                        c[1] = (double(j) + double(testdirections.at(m).at(1)) / 2.0) * spacing[1] + origin[1] +
-                                spacing[1] / 2.0;
-                        c[2] = (double(k) + double(testdirections.at(m).at(2)) / 2.0) * spacing[2] + origin[2] +
-                                spacing[2] / 2.0;
-
-                        // Compute coordinate of corner point
-                        double delta[3];
-                        delta[0] = spacing[0] * vdirections.at(m)[0] / 2.0;
-                        delta[1] = spacing[1] * vdirections.at(m)[1] / 2.0;
-                        delta[2] = spacing[2] * vdirections.at(m)[2] / 2.0;
-
-                        std::vector<int> VoxelIDs;
-
-
-                        for (auto s1 : signs) {
-                            for (auto s2 : signs) {
-                                double newvertex[3];
-                                newvertex[0] = c[0];
-                                newvertex[1] = c[1];
-                                newvertex[2] = c[2];
-
-                                newvertex[vindex.at(m).at(0)] =
-                                        newvertex[vindex.at(m).at(0)] + s1 * delta[vindex.at(m)[0]];
-                                newvertex[vindex.at(m).at(1)] =
-                                        newvertex[vindex.at(m).at(1)] + s2 * delta[vindex.at(m)[1]];
-
-                                int id = Mesh->VertexOctreeRoot->AddVertex(newvertex[0], newvertex[1],
-                                        newvertex[2]);
-                                LOG("Corner (id=%u) at (%f, %f, %f)\n", id, newvertex[0], newvertex[1],
-                                        newvertex[2]);
-                                VoxelIDs.push_back(id);
-                            }
-                        }
-                        AddSurfaceSquare(VoxelIDs, {ThisPhase, NeighboringPhase}, NeighboringPhase);
-                    }
+    STATUS("\tFind surfaces\n", 0);
+
+    int dim[3];
+    double spacing[3];
+    this->Imp->GiveDimensions(dim);
+    this->Imp->GiveSpacing(spacing);
+
+    STATUS("\tTotal volume: %f\n", dim[0] * spacing[0] * dim[1] * spacing[1] * dim[2] * spacing[2]);
+
+    // Find faces between voxels of different materials. The grid is split into slabs of consecutive i, which is the
+    // outermost index of the face order. Each slab is scanned on a separate thread and merged in order, which gives the
+    // same faces and vertex IDs as scanning the whole grid at once.
+    LabelGridBase *Labels = this->Imp->GiveLabelGrid();
+    std::vector<VoxelSlabType> Slabs(std::max(1u, GiveNumberOfThreads()));
+    ParallelForRanges(0, dim[0], [&](unsigned int ThreadID, size_t FirstColumn, size_t LastColumn) {
+        this->FindSlabFaces(Labels, (int) FirstColumn, (int) LastColumn, Slabs[ThreadID]);
+    }, (unsigned int) Slabs.size());
+
+    // Corners are welded by their lattice indices. Thus, new vertices need not be looked up in the octree.
+    size_t NumberOfCorners = 0;
+    for (VoxelSlabType &Slab : Slabs) {
+        NumberOfCorners += Slab.Corners.size();
+    }
+    this->LatticeVertices.Initialize(dim, NumberOfCorners);
+
+    // Each face is split into two triangles, (0, 2, 1) and (2, 3, 1), where the corners are ordered as in FindSlabFaces
+    std::vector<IDType> TriangleVertexIDs;
+    std::vector<int> InterfaceIDs;
+    std::vector<std::array<int, 2> > FacePhases;
+
+    for (VoxelSlabType &Slab : Slabs) {
+        std::vector<IDType> CornerIDs(Slab.Corners.size());
+        for (size_t i = 0; i < Slab.Corners.size(); i++) {
+            std::array<double, 3> &newvertex = Slab.Corners[i];
+            std::pair<IDType, bool> Inserted = this->LatticeVertices.Insert(Slab.CornerKeys[i],
+                                                                             (IDType) Mesh->Vertices.size());
+            if (Inserted.second) {
+                Mesh->VertexOctreeRoot->AddNewVertex(newvertex[0], newvertex[1], newvertex[2]);
+            }
+            CornerIDs[i] = Inserted.first;
+            LOG("Corner (id=%lld) at (%f, %f, %f)\n", (long long) CornerIDs[i], newvertex[0], newvertex[1],
+                newvertex[2]);
+        }
+
+        for (size_t i = 0; i < Slab.Faces.size(); i++) {
+            VoxelFaceType &Face = Slab.Faces[i];
+            const size_t *Corners = &Slab.FaceCorners[i * 4];
+            int SurfaceID = this->FindOrAddSurface({{Face.ThisPhase, Face.NeighboringPhase}});
+            for (int j : {0, 2, 1, 2, 3, 1}) {
+                TriangleVertexIDs.push_back(CornerIDs[Corners[j]]);
+            }
+            InterfaceIDs.push_back(SurfaceID);
+            InterfaceIDs.push_back(SurfaceID);
+            FacePhases.push_back({{Face.ThisPhase, Face.NeighboringPhase}});
+        }
+
+        // Release the slab as soon as it is merged
+        Slab = VoxelSlabType();
+    }
+
+    std::vector<EdgeType *> TriangleEdges;
+    std::vector<TriangleType *> NewTriangles = this->Mesh->AddTriangles(TriangleVertexIDs, InterfaceIDs,
+                                                                          &TriangleEdges);
+
+    for (size_t f = 0; f < FacePhases.size(); f++) {
+        TriangleType *triangle0 = NewTriangles[f * 2];
+        TriangleType *triangle1 = NewTriangles[f * 2 + 1];
+
+        // Mark the transverse edge, i.e. the edge between corner 2 and 1 shared by both triangles. This edge should not
+        // have any stiffness since some vertices will be connected to more vertices than others, thus creating an
+        // unbalanced smoothing.
+        for (int j : {0, 2, 3, 4}) {
+            TriangleEdges[f * 6 + j]->IsTransverse = false;
+        }
+        TriangleEdges[f * 6 + 1]->IsTransverse = true;
+
+        // Check phases - This is kind of a dirty hack. Should not be neccessary to check the phase on the positive side
+        // once again.
+        std::array<double, 3> cm = triangle1->GiveCenterOfMass();
+        std::array<double, 3> normal = triangle0->GiveUnitNormal();
+
+        for (int i = 0; i < 3; i++) {
+            normal[i] = normal[i] * spacing[i] * .5;
+        }
+
+        int pPhase;
+        pPhase = this->Imp->GiveMaterialIDByCoordinate(cm[0] + normal[0], cm[1] + normal[1], cm[2] + normal[2]);
+
+        triangle0->PosNormalMatID = triangle1->PosNormalMatID = pPhase;
+
+        if (FacePhases[f][0] == pPhase) {
+            triangle0->NegNormalMatID = triangle1->NegNormalMatID = FacePhases[f][1];
+        } else {
+            triangle0->NegNormalMatID = triangle1->NegNormalMatID = FacePhases[f][0];
+        }
+    }
+
+    // Add the corners to the surfaces, in the order they first appear on each surface. Faces are grouped by surface,
+    // which allows marking the vertices already added to the current surface.
+    std::vector<size_t> SurfaceOffsets(this->Surfaces.size() + 1, 0);
+    for (size_t f = 0; f < FacePhases.size(); f++) {
+        SurfaceOffsets[InterfaceIDs[f * 2] + 1]++;
+    }
+    for (size_t s = 0; s < this->Surfaces.size(); s++) {
+        SurfaceOffsets[s + 1] += SurfaceOffsets[s];
+    }
+    std::vector<size_t> FacesBySurface(FacePhases.size());
+    std::vector<size_t> NextFace(SurfaceOffsets.begin(), SurfaceOffsets.end() - 1);
+    for (size_t f = 0; f < FacePhases.size(); f++) {
+        FacesBySurface[NextFace[InterfaceIDs[f * 2]]++] = f;
+    }
+
+    // At the same time, count the surfaces touching each vertex
+    std::vector<int> VertexSurface(this->Mesh->Vertices.size(), -1);
+    this->VertexSurfaceOffsets.assign(this->Mesh->Vertices.size() + 1, 0);
+    for (size_t s = 0; s < this->Surfaces.size(); s++) {
+        Surface *ThisSurface = this->Surfaces[s];
+        for (size_t i = SurfaceOffsets[s]; i < SurfaceOffsets[s + 1]; i++) {
+            size_t f = FacesBySurface[i];
+            // Corners 0, 1, 2 and 3 are found at positions 0, 2, 1 and 4 of the triangle vertex list
+            for (int j : {0, 2, 1, 4}) {
+                IDType VertexID = TriangleVertexIDs[f * 6 + j];
+                if (VertexSurface[VertexID] != (int) s) {
+                    VertexSurface[VertexID] = (int) s;
+                    ThisSurface->Vertices.push_back(this->Mesh->Vertices[VertexID]);
+                    this->VertexSurfaceOffsets[VertexID + 1]++;
                 }
             }
         }
     }
 
+    // Build the lists of surfaces touching each vertex
+    for (size_t i = 0; i < this->Mesh->Vertices.size(); i++) {
+        this->VertexSurfaceOffsets[i + 1] += this->VertexSurfaceOffsets[i];
+    }
+    this->VertexSurfaces.resize(this->VertexSurfaceOffsets.back());
+    std::vector<size_t> NextVertexSurface(this->VertexSurfaceOffsets.begin(), this->VertexSurfaceOffsets.end() - 1);
+    for (size_t s = 0; s < this->Surfaces.size(); s++) {
+        for (VertexType *v : this->Surfaces[s]->Vertices) {
+            this->VertexSurfaces[NextVertexSurface[v->ID]++] = (int) s;
+        }
+    }
+
     this->UpdateSurfaces();
 
     STATUS("Find volumes\n", 0);
@@ -534,7 +861,7 @@ void Voxel2TetClass::FindEdges()
 
     // Sort vertex vectors on all surfaces
     for (auto surface : this->Surfaces) {
-        std::sort(surface->Vertices.begin(), surface->Vertices.end());
+        std::sort(surface->Vertices.begin(), surface->Vertices.end(), SortByID<VertexType *>);
     }
 
     std::vector<VertexType *> EdgeVertices;
@@ -542,131 +869,122 @@ void Voxel2TetClass::FindEdges()
     // Find all vertices that are shared among the surfaces. Since this is in 3D,
     // one vertex can be shared by several surfaces while not being an endpoint
     // of the edge. Thus, first find all shared vertices and then trace along x, y, z
-    // to find the edge
-
-    for (unsigned int s1 = 0; s1 < this->Surfaces.size(); s1++) {
-        Surface *surface1 = this->Surfaces.at(s1);
-        std::vector<VertexType *> SurfaceEdgeVertices;
-        for (unsigned int s2 = 0; s2 < this->Surfaces.size(); s2++) {
-            Surface *surface2 = this->Surfaces.at(s2);
-
-            for (int i = 0; i < 2; i++) {
-                if (s1 == s2) {
-                    break;
-                }
-                bool SharedPhaseFound = false;
-                std::vector<VertexType *> SharedVertices;
-                int mat1 = surface1->Phases[i];
-                for (int j = 0; j < 2; j++) {
-                    int mat2 = surface2->Phases[j];
-                    if (mat1 == mat2) {
-                        LOG("Surfaces %p and %p shares phase %i\n", surface1, surface2, mat1);
-
+    // to find the edge.
+    //
+    // A vertex is shared if it touches two surfaces with a phase in common. The surfaces touching each vertex are
+    // known from FindSurfaces, so this is a single pass over the vertices.
+    for (size_t VertexID = 0; VertexID + 1 < this->VertexSurfaceOffsets.size(); VertexID++) {
+        size_t First = this->VertexSurfaceOffsets[VertexID];
+        size_t Last = this->VertexSurfaceOffsets[VertexID + 1];
+
+        bool SharedPhaseFound = false;
+        for (size_t i = First; (i < Last) && !SharedPhaseFound; i++) {
+            Surface *surface1 = this->Surfaces.at(this->VertexSurfaces[i]);
+            for (size_t j = i + 1; (j < Last) && !SharedPhaseFound; j++) {
+                Surface *surface2 = this->Surfaces.at(this->VertexSurfaces[j]);
+                for (int mat1 : surface1->Phases) {
+                    if ((mat1 == surface2->Phases[0]) || (mat1 == surface2->Phases[1])) {
                         SharedPhaseFound = true;
-
-                        std::set_intersection(surface1->Vertices.begin(), surface1->Vertices.end(),
-                                              surface2->Vertices.begin(), surface2->Vertices.end(),
-                                              back_inserter(SharedVertices));
-
-                        // If both sets of vertices has an intersection, that intersection is an edge
-                        if (SharedVertices.size() > 0) {
-                            LOG("Surfaces intersects\n", 0);
-                            for (auto Vertex : SharedVertices) {
-                                EdgeVertices.push_back(Vertex);
-                                SurfaceEdgeVertices.push_back(Vertex);
-                            }
-                        }
-                        break;
                     }
                 }
-                if (SharedPhaseFound) {
-                    break;
-                }
             }
         }
-        std::sort(SurfaceEdgeVertices.begin(), SurfaceEdgeVertices.end());
-        SurfaceEdgeVertices.erase(std::unique(SurfaceEdgeVertices.begin(), SurfaceEdgeVertices.end()),
-                                  SurfaceEdgeVertices.end());
 
-        for (auto v : SurfaceEdgeVertices) {
+        if (SharedPhaseFound) {
+            VertexType *v = this->Mesh->Vertices.at(VertexID);
+            LOG("Vertex %p is shared by surfaces\n", v);
+            EdgeVertices.push_back(v);
             v->Fixed = {{true, true, true}};
         }
     }
 
     STATUS("\tTrace edges...\n", 0);
 
-    std::sort(EdgeVertices.begin(), EdgeVertices.end());
-    EdgeVertices.erase(std::unique(EdgeVertices.begin(), EdgeVertices.end()), EdgeVertices.end());
-
     // Trace edges by for each vertex in EdgeVertices:
     //  * Check if the neightbour is in EdgeVertices as well
     //    * If so, add the edge segment to edge separating the materials surounding the midpoint of edge segment
+    //
+    // EdgeVertices is in order of vertex ID, which makes the order of the edge segments, and thus of the phase edges,
+    // independent of where the vertices are allocated. The tracing is done in parallel over parts of EdgeVertices and
+    // the segments found are added to the phase edges afterwards, part by part, in the same order as if done serially.
 
-    // Used to check which material surround the midpoint. See FindSurfaces for explanation.
-    std::vector<std::vector<double> > testdirections = {{1, 0, 0},
-                                                        {0, 1, 0},
-                                                        {0, 0, 1}};
-    std::vector<std::vector<double> > vdirections = {{0, 1, 1},
-                                                     {1, 0, 1},
-                                                     {1, 1, 0}};
-    std::vector<std::vector<int> > vindex = {{1, 2},
-                                             {0, 2},
-                                             {0, 1}};
-    std::vector<double> signs = {
-        1, -1
-    };
+    std::vector<char> IsEdgeVertex(this->Mesh->Vertices.size(), 0);
+    for (auto v : EdgeVertices) {
+        IsEdgeVertex[v->ID] = 1;
+    }
 
-    double spacing[3];
+    // Indices of the two directions perpendicular to each direction
+    const int vindex[3][2] = {{1, 2},
+                              {0, 2},
+                              {0, 1}};
+
+    double spacing[3], origin[3];
     this->Imp->GiveSpacing(spacing);
+    this->Imp->GiveOrigin(origin);
 
-    for (auto v : EdgeVertices) {
-        for (int i = 0; i < 3; i++) {
-            // Find neighbour
-            double c[3];
+    // The materials surrounding the midpoint of a segment are given by the voxels sharing the segment, which are read
+    // directly from the label grid used by FindSurfaces. See FindSurfaces for explanation.
+    LabelGridBase *Labels = this->Imp->GiveLabelGrid();
+
+    struct EdgeSegmentType
+    {
+        VertexType *Vertices[2];
+        std::vector<int> Phases;
+    };
+
+    std::vector<std::vector<EdgeSegmentType> > PartSegments(std::max(1u, GiveNumberOfThreads()));
+
+    ParallelForRanges(0, EdgeVertices.size(), [&](unsigned int ThreadID, size_t First, size_t Last) {
+        std::vector<EdgeSegmentType> &Segments = PartSegments[ThreadID];
+
+        for (size_t n = First; n < Last; n++) {
+            VertexType *v = EdgeVertices[n];
+
+            // Vertices are still located in the lattice of voxel corners
+            int Lattice[3];
             for (int j = 0; j < 3; j++) {
-                c[j] = v->get_c(j) + testdirections.at(i).at(j) * spacing[j];
+                Lattice[j] = (int) std::lround((v->get_c(j) - origin[j]) / spacing[j]);
             }
-            VertexType *Neighbour = this->Mesh->VertexOctreeRoot->FindVertexByCoords(c[0], c[1], c[2]);
 
-            if (std::find(EdgeVertices.begin(), EdgeVertices.end(), Neighbour) != EdgeVertices.end()) {
-                LOG("Found Neightbour %p for %p\n", Neighbour, v);
-                double cm[3];
-                for (int j = 0; j < 3; j++) {
-                    cm[j] = v->get_c(j) + testdirections.at(i).at(j) * spacing[j] / 2;
+            for (int i = 0; i < 3; i++) {
+                // Find neighbour
+                IDType NeighbourID = this->LatticeVertices.Find(Lattice[0] + (i == 0), Lattice[1] + (i == 1),
+                                                                Lattice[2] + (i == 2));
+
+                if ((NeighbourID < 0) || !IsEdgeVertex[NeighbourID]) {
+                    continue;
                 }
 
-                // Check phases surrounding cm
-                double delta[3];
-                delta[0] = spacing[0] * vdirections.at(i)[0] / 2.0;
-                delta[1] = spacing[1] * vdirections.at(i)[1] / 2.0;
-                delta[2] = spacing[2] * vdirections.at(i)[2] / 2.0;
-                std::vector<int> Phases;
-
-                for (auto s1 : signs) {
-                    for (auto s2 : signs) {
-                        double testpoint[3];
-                        testpoint[0] = cm[0];
-                        testpoint[1] = cm[1];
-                        testpoint[2] = cm[2];
-
-                        testpoint[vindex.at(i).at(0)] = testpoint[vindex.at(i).at(0)] + s1 * delta[vindex.at(i)[0]];
-                        testpoint[vindex.at(i).at(1)] = testpoint[vindex.at(i).at(1)] + s2 * delta[vindex.at(i)[1]];
-
-                        int matid = this->Imp->GiveMaterialIDByCoordinate(testpoint[0], testpoint[1], testpoint[2]);
-                        Phases.push_back(matid);
+                // Check phases of the four voxels surrounding the segment
+                int Phases[4];
+                int NumberOfPhases = 0;
+                for (int s1 = 0; s1 >= -1; s1--) {
+                    for (int s2 = 0; s2 >= -1; s2--) {
+                        int Voxel[3] = {Lattice[0], Lattice[1], Lattice[2]};
+                        Voxel[vindex[i][0]] += s1;
+                        Voxel[vindex[i][1]] += s2;
+                        Phases[NumberOfPhases++] = Labels->GiveMaterialID(Labels->GiveIndex(Voxel[0], Voxel[1], Voxel[2]));
                     }
                 }
 
-                // If 3 or 4 phases surrounds cm, this is a PhaseEdge
-                std::sort(Phases.begin(), Phases.end());
-                Phases.erase(std::unique(Phases.begin(), Phases.end()), Phases.end());
+                // If 3 or 4 phases surrounds the midpoint, this is a PhaseEdge
+                std::sort(Phases, Phases + 4);
+                NumberOfPhases = (int) (std::unique(Phases, Phases + 4) - Phases);
 
-                if (Phases.size() >= 3) {
-                    LOG("PhaseEdge found. Add it to the list and add PhaseEdge to Vertex\n", 0);
-                    AddPhaseEdge({v, Neighbour}, Phases);
+                if (NumberOfPhases >= 3) {
+                    Segments.push_back({{v, this->Mesh->Vertices.at(NeighbourID)},
+                                        std::vector<int>(Phases, Phases + NumberOfPhases)});
                 }
             }
         }
+    });
+
+    for (std::vector<EdgeSegmentType> &Segments : PartSegments) {
+        for (EdgeSegmentType &Segment : Segments) {
+            LOG("PhaseEdge found between %p and %p. Add it to the list and add PhaseEdge to Vertex\n",
+                Segment.Vertices[0], Segment.Vertices[1]);
+            AddPhaseEdge({Segment.Vertices[0], Segment.Vertices[1]}, Segment.Phases);
+        }
     }
 
     LOG("Phase edges:\n", 0);
@@ -699,6 +1017,15 @@ void Voxel2TetClass::FindEdges()
          * delete FixedEdges;*/
     }
 
+    // The traced edges have been replaced. Index the final edges by their phases instead.
+    this->TracedPhaseEdges.clear();
+    this->PhaseEdgeIndex.clear();
+    for (PhaseEdge *p : this->PhaseEdges) {
+        std::vector<int> PhaseEdgePhases = p->Phases;
+        std::sort(PhaseEdgePhases.begin(), PhaseEdgePhases.end());
+        this->PhaseEdgeIndex[PhaseEdgePhases].push_back(p);
+    }
+
     LOG("Phase edges:\n", 0);
     for (PhaseEdge *p: PhaseEdges) {
         p->LogPhaseEdge();
@@ -710,7 +1037,7 @@ void Voxel2TetClass::FindEdges()
     // Add all vertices to a list from unique lists of vertices of each PhaseEdge
     std::vector<VertexType *> VertexList;
     for (auto e : this->PhaseEdges) {
-        std::vector<VertexType *> FlatList = e->GetFlatListOfVertices();
+        const std::vector<VertexType *> &FlatList = e->GetFlatListOfVertices();
         VertexList.insert(VertexList.end(), FlatList.begin(), FlatList.end());
     }
 
@@ -733,35 +1060,33 @@ void Voxel2TetClass::FindEdges()
         }
     }
 
-    // Add PhaseEdges to surfaces
-    // TODO: Performance can be increased by making sure that the vertices in Surfaces and PhaseEdges are sorted. Also, save the sorted list in PhaseEdges
-    int x = 0;
-    for (Surface *s : this->Surfaces) {
-        std::vector<VertexType *> SurfaceVertices;
-        for (VertexType *v : s->Vertices) {
-            SurfaceVertices.push_back(v);
-        }
-        std::sort(SurfaceVertices.begin(), SurfaceVertices.end());
-        int SurfacePhases[2];
-        SurfacePhases[0] = s->Phases[0];
-        SurfacePhases[1] = s->Phases[1];
-        std::sort(SurfacePhases, SurfacePhases + 2);
-
-        for (PhaseEdge *p : this->PhaseEdges) {
-            std::vector<int> PhaseEdgePhases = p->Phases;
-            std::sort(PhaseEdgePhases.begin(), PhaseEdgePhases.end());
-
-            // If the surface phases are a subset of the edges phases, they might be connected
-            if (std::includes(PhaseEdgePhases.begin(), PhaseEdgePhases.end(), SurfacePhases, SurfacePhases + 2)) {
-                std::vector<VertexType *> PhaseEdgeVertices = p->GetFlatListOfVertices();
-                std::sort(PhaseEdgeVertices.begin(), PhaseEdgeVertices.end());
-
-                if (std::includes(s->Vertices.begin(), s->Vertices.end(),
+    // Add PhaseEdges to surfaces. Each pair of phases of a PhaseEdge may have a surface connected to the edge.
+    std::vector<std::vector<VertexType *> > SortedSurfaceVertices(this->Surfaces.size());
+    for (PhaseEdge *p : this->PhaseEdges) {
+        std::vector<int> PhaseEdgePhases = p->Phases;
+        std::sort(PhaseEdgePhases.begin(), PhaseEdgePhases.end());
+
+        const std::vector<VertexType *> &PhaseEdgeVertices = p->GiveSortedListOfVertices();
+
+        for (size_t j = 0; j < PhaseEdgePhases.size(); j++) {
+            for (size_t k = j + 1; k < PhaseEdgePhases.size(); k++) {
+                auto it = this->SurfaceIndex.find(GivePhasePairKey(PhaseEdgePhases[j], PhaseEdgePhases[k]));
+                if (it == this->SurfaceIndex.end()) {
+                    continue;
+                }
+
+                Surface *s = this->Surfaces.at(it->second);
+                std::vector<VertexType *> &SurfaceVertices = SortedSurfaceVertices.at(it->second);
+                if (SurfaceVertices.empty()) {
+                    SurfaceVertices = s->Vertices;
+                    std::sort(SurfaceVertices.begin(), SurfaceVertices.end());
+                }
+
+                if (std::includes(SurfaceVertices.begin(), SurfaceVertices.end(),
                                   PhaseEdgeVertices.begin(), PhaseEdgeVertices.end())) {
                     s->PhaseEdges.push_back(p);
                 }
             }
-            x++;
         }
     }
 }
@@ -783,7 +1108,7 @@ void Voxel2TetClass::SmoothEdgesSimultaneously()
     struct by_vertexptr
     {
         bool operator()(VertexConnectivity *a, VertexConnectivity *b)
-        { return (a->v < b->v); }
+        { return (a->v->ID < b->v->ID); }
     };
 
     std::vector<VertexConnectivity *> VertexConnections;
@@ -794,7 +1119,7 @@ void Voxel2TetClass::SmoothEdgesSimultaneously()
         std::vector<std::vector<VertexType *> > Connections;
         std::vector<std::array<bool, 3> > FixedDirectionsList;
 
-        std::vector<VertexType *> EdgeVertices = p->GetFlatListOfVertices();
+        const std::vector<VertexType *> &EdgeVertices = p->GetFlatListOfVertices();
         p->GiveTopologyLists(&Connections, &FixedDirectionsList);
 
         for (unsigned int i = 0; i < EdgeVertices.size(); i++) {
@@ -808,7 +1133,8 @@ void Voxel2TetClass::SmoothEdgesSimultaneously()
         j++;
     }
 
-    // Sort list by VertexType address and merge information of duplicate vertices
+    // Sort list by vertex ID and merge information of duplicate vertices. The order of the list is the order in which
+    // the smoother visits the vertices, so it must not depend on where the vertices are allocated.
     std::sort(VertexConnections.begin(), VertexConnections.end(), by_vertexptr());
 
     unsigned int i = 0;
@@ -823,7 +1149,7 @@ void Voxel2TetClass::SmoothEdgesSimultaneously()
                                            nextvc->Connections.end());
 
                 // Uniqueify connections
-                std::sort(thisvc->Connections.begin(), thisvc->Connections.end());
+                std::sort(thisvc->Connections.begin(), thisvc->Connections.end(), SortByID<VertexType *>);
                 std::vector<VertexType *>::iterator it;
                 it = std::unique(thisvc->Connections.begin(), thisvc->Connections.end());
                 if (it != thisvc->Connections.end()) {
@@ -912,15 +1238,9 @@ PhaseEdge *Voxel2TetClass::AddPhaseEdge(std::vector<VertexType *> EdgeSegment, s
     Phases.erase(std::unique(Phases.begin(), Phases.end()), Phases.end());
 
     // Find PhaseEdge
-    for (auto pe : this->PhaseEdges) {
-        std::vector<int> PhaseDiff;
-        std::set_difference(Phases.begin(), Phases.end(),
-                            pe->Phases.begin(), pe->Phases.end(),
-                            back_inserter(PhaseDiff));
-        if (PhaseDiff.size() == 0) {
-            ThisPhaseEdge = pe;
-            break;
-        }
+    auto it = this->TracedPhaseEdges.find(Phases);
+    if (it != this->TracedPhaseEdges.end()) {
+        ThisPhaseEdge = it->second;
     }
 
     // If PhaseEdge does not exists, create it
@@ -928,6 +1248,17 @@ PhaseEdge *Voxel2TetClass::AddPhaseEdge(std::vector<VertexType *> EdgeSegment, s
         ThisPhaseEdge = new PhaseEdge(this->Opt, this->EdgeSmoother);
         ThisPhaseEdge->Phases = Phases;
         this->PhaseEdges.push_back(ThisPhaseEdge);
+
+        // Segments separating all phases of this edge, or all but one of them, are added to this edge unless an
+        // earlier edge already includes those phases
+        this->TracedPhaseEdges.emplace(Phases, ThisPhaseEdge);
+        if (Phases.size() > 3) {
+            for (size_t i = 0; i < Phases.size(); i++) {
+                std::vector<int> SubPhases = Phases;
+                SubPhases.erase(SubPhases.begin() + i);
+                this->TracedPhaseEdges.emplace(SubPhases, ThisPhaseEdge);
+            }
+        }
     }
 
     for (VertexType *v : EdgeSegment) {
@@ -939,83 +1270,48 @@ PhaseEdge *Voxel2TetClass::AddPhaseEdge(std::vector<VertexType *> EdgeSegment, s
     return ThisPhaseEdge;
 }
 
-void Voxel2TetClass::AddSurfaceSquare(std::vector<int> VertexIDs, std::vector<int> phases, int normalphase)
+uint64_t Voxel2TetClass::GivePhasePairKey(int Phase0, int Phase1)
 {
-    // Check is surface exists
-    Surface *ThisSurface = NULL;
-    int SurfaceID;
-    for (unsigned int i = 0; i < this->Surfaces.size(); i++) {
-        if (((this->Surfaces.at(i)->Phases[0] == phases.at(0)) &
-             (this->Surfaces.at(i)->Phases[1] == phases.at(1))) |
-                ((this->Surfaces.at(i)->Phases[0] == phases.at(1)) &
-                 (this->Surfaces.at(i)->Phases[1] == phases.at(0)))) {
-            ThisSurface = this->Surfaces.at(i);
-            SurfaceID = i;
-            break;
-        }
+    if (Phase0 > Phase1) {
+        std::swap(Phase0, Phase1);
     }
+    return ((uint64_t) (uint32_t) Phase0 << 32) | (uint64_t) (uint32_t) Phase1;
+}
 
-    // If not, create it and add it to the list
-    if (ThisSurface == NULL) {
-        ThisSurface = new Surface(phases.at(0), phases.at(1), this->Opt, this->SurfaceSmoother);
-        this->Surfaces.push_back(ThisSurface);
-        SurfaceID = this->Surfaces.size() - 1;
-    }
-
-    // Create square (i.e. two triangles)
-    TriangleType *triangle0, *triangle1;
-    triangle0 = Mesh->AddTriangle({VertexIDs.at(0), VertexIDs.at(2), VertexIDs.at(1)});
-    triangle1 = Mesh->AddTriangle({VertexIDs.at(2), VertexIDs.at(3), VertexIDs.at(1)});
-
-    // Find the transverse edge and mark it. This edge should not have any stiffness since some vertices will be connected to more vertices than others, thus creating an unbalanced smoothing.
-
-    std::array<EdgeType *, 3> e0 = triangle0->GiveEdges();
-    std::array<EdgeType *, 3> e1 = triangle1->GiveEdges();
-
-    std::vector<EdgeType *> SharedEdge;
-    std::set_intersection(e0.begin(), e0.end(), e1.begin(), e1.end(), back_inserter(SharedEdge),
-                          SortByID<EdgeType *>);
-
-    std::vector<EdgeType *> NotSharedEdges;
-    std::set_symmetric_difference(e0.begin(), e0.end(), e1.begin(), e1.end(), back_inserter(NotSharedEdges),
-                                  SortByID<EdgeType *>);
-
-    SharedEdge[0]->IsTransverse = true;
-
-    for (EdgeType *e: NotSharedEdges) {
-        e->IsTransverse = false;
+int Voxel2TetClass::FindOrAddSurface(std::array<int, 2> Phases)
+{
+    // Check is surface exists
+    auto it = this->SurfaceIndex.find(GivePhasePairKey(Phases[0], Phases[1]));
+    if (it != this->SurfaceIndex.end()) {
+        return it->second;
     }
 
-    triangle0->InterfaceID = triangle1->InterfaceID = SurfaceID;
-
-    // Check phases - This is kind of a dirty hack. Should not be neccessary to check the phase on the positive side once again.
-
-    std::array<double, 3> cm = triangle1->GiveCenterOfMass();
-    std::array<double, 3> normal = triangle0->GiveUnitNormal();
-    double spacing[3];
-    this->Imp->GiveSpacing(spacing);
+    // If not, create it and add it to the list
+    Surface *NewSurface = new Surface(Phases[0], Phases[1], this->Opt, this->SurfaceSmoother);
+    this->Surfaces.push_back(NewSurface);
+    this->SurfaceIndex[GivePhasePairKey(Phases[0], Phases[1])] = this->Surfaces.size() - 1;
+    return this->Surfaces.size() - 1;
+}
 
-    for (int i = 0; i < 3; i++) {
-        normal[i] = normal[i] * spacing[i] * .5;
+Surface *Voxel2TetClass::GiveSurface(int Phase0, int Phase1)
+{
+    auto it = this->SurfaceIndex.find(GivePhasePairKey(Phase0, Phase1));
+    if (it == this->SurfaceIndex.end()) {
+        return NULL;
     }
+    return this->Surfaces.at(it->second);
+}
 
-    int pPhase;
-    pPhase = this->Imp->GiveMaterialIDByCoordinate(cm[0] + normal[0], cm[1] + normal[1], cm[2] + normal[2]);
-
-    triangle0->PosNormalMatID = triangle1->PosNormalMatID = pPhase;
-
-    if (phases[0] == pPhase) {
-        triangle0->NegNormalMatID = triangle1->NegNormalMatID = phases[1];
-    } else {
-        triangle0->NegNormalMatID = triangle1->NegNormalMatID = phases[0];
-    }
+std::vector<PhaseEdge *> Voxel2TetClass::GivePhaseEdges(std::vector<int> Phases)
+{
+    std::sort(Phases.begin(), Phases.end());
+    Phases.erase(std::unique(Phases.begin(), Phases.end()), Phases.end());
 
-    // Update surface
-    ThisSurface->AddTriangle(triangle0);
-    ThisSurface->AddTriangle(triangle1);
-    for (int i = 0; i < 4; i++) {
-        ThisSurface->AddVertex(this->Mesh->Vertices.at(VertexIDs.at(i)));
+    auto it = this->PhaseEdgeIndex.find(Phases);
+    if (it == this->PhaseEdgeIndex.end()) {
+        return {};
     }
+    return it->second;
 }
 
 double Voxel2TetClass::GetListOfVolumes(std::vector<double> &VolumeList, std::vector<int> &PhaseList)
@@ -1071,6 +1367,9 @@ void Voxel2TetClass::Process()
 
     Timer.StartTimer("Find edges");
     this->FindEdges();
+    this->LatticeVertices.Clear();
+    std::vector<size_t>().swap(this->VertexSurfaceOffsets);
+    std::vector<int>().swap(this->VertexSurfaces);
     Timer.StopTimer();
 
     Timer.StartTimer("Smooth edges");
@@ -1279,9 +1578,15 @@ void Voxel2TetClass::ExportStatistics()
              << this->Opt->GiveStringValue("TOL_COL_MAXERROR_ACCUMULATED_FACTOR") << "\n";
 
     StatFile << "\nMesh\n----\n";
-    StatFile << "Number of input voxels: " << dimensions[0] * dimensions[1] * dimensions[2] << "\n";
-    StatFile << "Number of input nodes: " << (dimensions[0] + 1) * (dimensions[1] + 1) * (dimensions[2] + 1)
+    StatFile << "Number of input voxels: " << (size_t) dimensions[0] * dimensions[1] * dimensions[2] << "\n";
+    StatFile << "Number of input nodes: " << (size_t) (dimensions[0] + 1) * (dimensions[1] + 1) * (dimensions[2] + 1)
             << "\n";
+    LabelGridBase *Labels = this->Imp->GiveLabelGrid();
+    size_t NumberOfVoxels = (size_t) dimensions[0] * dimensions[1] * dimensions[2];
+    StatFile << "Number of uniform voxel bricks (" << LabelGridBase::BrickSize << "^3): "
+             << Labels->GiveNumberOfUniformBricks() << " of " << Labels->GiveNumberOfBricks() << "\n";
+    StatFile << "Voxels skipped in uniform bricks: " << Labels->GiveNumberOfUniformVoxels() << " ("
+             << (NumberOfVoxels > 0 ? 100.0 * Labels->GiveNumberOfUniformVoxels() / NumberOfVoxels : 0.0) << "%)\n";
     StatFile << "Number of output elements: " << this->Mesh->Tets.size() << "\n";
     StatFile << "Number of output nodes: " << this->Mesh->Vertices.size() << "\n";
 
@@ -1325,7 +1630,17 @@ void Voxel2TetClass::ExportStatistics()
 
     StatFile << "\n\nWeighted error: " << E;
 
-    StatFile << "\n\nTime\n----\n";
+    StatFile << "\n\nMesh entity allocations\n-----------------------\n";
+    if (this->SurfaceMeshAllocations.empty()) { // Not tetrahedralized, i.e. Mesh is the surface mesh
+        StatFile << "Surface mesh:\n";
+        this->Mesh->WriteAllocationStatistics(StatFile);
+    } else {
+        StatFile << "Surface mesh:\n" << this->SurfaceMeshAllocations;
+        StatFile << "Volume mesh:\n";
+        this->Mesh->WriteAllocationStatistics(StatFile);
+    }
+
+    StatFile << "\nTime\n----\n";
 
     std::vector<std::pair<double, std::string> > TimeTable = this->Timer.GetTable();
     for (std::pair<double, std::string> stamp : TimeTable) {
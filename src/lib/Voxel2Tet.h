@@ -2,14 +2,18 @@
 #define VOXEL2TET_H
 
 #include <vector>
+#include <array>
 #include <string>
+#include <unordered_map>
 
 #include "Options.h"
 
 #include "Importer.h"
 #include "CallbackImporter.h"
+#include "ArrayImporter.h"
 #include "Dream3DDataReader.h"
 #include "VTKStructuredReader.h"
+#include "NRRDReader.h"
 
 #include "MiscFunctions.h"
 #include "MeshComponents.h"
@@ -21,9 +25,79 @@
 #include "MeshGenerator3D.h"
 #include "TimeStamp.h"
 #include "Smoother.h"
+#include "LatticeVertexMap.h"
 
 namespace voxel2tet
 {
+
+/**
+ * @brief Square face separating a voxel from a neighbouring voxel of another material
+ */
+typedef struct
+{
+    /**
+     * @brief Indices of the voxel
+     */
+    int Indices[3];
+
+    /**
+     * @brief Direction to the neighbouring voxel. 0, 1 and 2 is +x, +y and +z and 3, 4 and 5 is -x, -y and -z.
+     */
+    int Direction;
+
+    /**
+     * @brief Material of the voxel
+     */
+    int ThisPhase;
+
+    /**
+     * @brief Material of the neighbouring voxel
+     */
+    int NeighboringPhase;
+} VoxelFaceType;
+
+/**
+ * @brief Voxel faces of a slab of the voxel grid together with their corners. Corners shared by several faces of the slab
+ * are only stored once.
+ */
+typedef struct
+{
+    /**
+     * @brief Faces in the slab
+     */
+    std::vector<VoxelFaceType> Faces;
+
+    /**
+     * @brief Coordinates of the distinct corners, in the order they first appear in Faces
+     */
+    std::vector<std::array<double, 3> > Corners;
+
+    /**
+     * @brief Lattice keys (cf. LatticeVertexMap) of the distinct corners
+     */
+    std::vector<uint64_t> CornerKeys;
+
+    /**
+     * @brief Four indices into Corners for each face
+     */
+    std::vector<size_t> FaceCorners;
+} VoxelSlabType;
+
+/**
+ * @brief Hash of a sorted list of phases, used as key when looking up interfaces by the phases they separate
+ */
+struct PhaseTupleHash
+{
+    size_t operator()(const std::vector<int> &Phases) const
+    {
+        uint64_t h = 1469598103934665603ULL;
+        for (int p : Phases) {
+            h = (h ^ (uint32_t) p) * 1099511628211ULL;
+        }
+        return (size_t) h;
+    }
+};
+
 /**
  * @brief The main class of the library. It supplies functions for loading and exporting data through one function, starting the smoothing process and more overall functions.
  */
@@ -36,20 +110,102 @@ private:
     std::vector<Volume *> Volumes;
     std::vector<PhaseEdge *> PhaseEdges;
 
+    /**
+     * @brief Vertex IDs of the voxel corners on the surfaces. Only valid from FindSurfaces until the edges are found,
+     * i.e. while all vertices still are in the lattice.
+     */
+    LatticeVertexMap LatticeVertices;
+
+    /**
+     * @brief Surfaces touching each vertex, given as indices in Surfaces in increasing order. The surfaces of the vertex
+     * with ID i are VertexSurfaces[VertexSurfaceOffsets[i]], ..., VertexSurfaces[VertexSurfaceOffsets[i + 1] - 1]. Only
+     * valid from FindSurfaces until the edges are found.
+     */
+    std::vector<size_t> VertexSurfaceOffsets;
+
+    /**
+     * @brief See VertexSurfaceOffsets
+     */
+    std::vector<int> VertexSurfaces;
+
+    /**
+     * @brief Index in Surfaces of the surface separating a pair of phases. The key is given by GivePhasePairKey.
+     */
+    std::unordered_map<uint64_t, int> SurfaceIndex;
+
+    /**
+     * @brief PhaseEdges by the sorted list of phases they separate. Only valid after FindEdges.
+     */
+    std::unordered_map<std::vector<int>, std::vector<PhaseEdge *>, PhaseTupleHash> PhaseEdgeIndex;
+
+    /**
+     * @brief Used while tracing the edges. Maps each sorted list of phases to the first PhaseEdge whose phases include
+     * all of them, i.e. the PhaseEdge a segment separating these phases is added to.
+     */
+    std::unordered_map<std::vector<int>, PhaseEdge *, PhaseTupleHash> TracedPhaseEdges;
+
+    /**
+     * @brief Gives the key of an unordered pair of phases in SurfaceIndex
+     */
+    static uint64_t GivePhasePairKey(int Phase0, int Phase1);
+
     void FindSurfaces();
 
+    /**
+     * @brief Finds all faces between voxels of different materials in the slab FirstColumn <= i < LastColumn of a label
+     * grid with labels of type T. The faces are given in the order of the voxel indices (i, j, k) with k varying fastest,
+     * and then by direction.
+     * @param Labels Label grid
+     * @param FirstColumn First voxel index i of slab
+     * @param LastColumn One past the last voxel index i of slab
+     * @param Faces Output. List of faces.
+     */
+    template <typename T>
+    void FindVoxelFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn, std::vector<VoxelFaceType> &Faces);
+
+    /**
+     * @brief Same as FindVoxelFaces for label grids stored in the bricked layout. The grid is traversed one brick at a
+     * time, while the faces are given in the same order as by FindVoxelFaces.
+     */
+    template <typename T>
+    void FindBrickedVoxelFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn, std::vector<VoxelFaceType> &Faces);
+
+    /**
+     * @brief Finds the voxel faces of a slab and the coordinates of their corners
+     * @param Labels Label grid
+     * @param FirstColumn First voxel index i of slab
+     * @param LastColumn One past the last voxel index i of slab
+     * @param Slab Output. Faces and corners.
+     */
+    void FindSlabFaces(LabelGridBase *Labels, int FirstColumn, int LastColumn, VoxelSlabType &Slab);
+
     void FindEdges();
 
     void SmoothEdgesSimultaneously();
 
     void SmoothSurfaces();
 
-    void AddSurfaceSquare(std::vector<int> VoxelIDs, std::vector<int> phases, int normalphase);
+    /**
+     * @brief Finds the surface separating two phases. If no such surface exists, it is created.
+     * @param Phases Phases on either side of the surface, in any order
+     * @return Index of surface in Surfaces
+     */
+    int FindOrAddSurface(std::array<int, 2> Phases);
 
     PhaseEdge *AddPhaseEdge(std::vector<VertexType *> EdgeSegment, std::vector<int> Phases);
 
     void FinalizeLoad();
 
+    /**
+     * @brief Sets the cut-out of the importer if the option voxelcutout is given
+     */
+    void ApplyCutOutOption();
+
+    /**
+     * @brief Sets the memory layout of the voxel data in the importer according to the option bricklayout
+     */
+    void ApplyLabelLayoutOption();
+
     void UpdateSurfaces();
 
     double eps = 1e-6;
@@ -60,6 +216,11 @@ private:
     std::vector<double> CurrentVolumes;
     std::vector<int> PhaseList;
 
+    /**
+     * @brief Allocation statistics of the surface mesh, written by Tetrahedralize before the surface mesh is replaced
+     */
+    std::string SurfaceMeshAllocations;
+
     Smoother *SurfaceSmoother;
     Smoother *EdgeSmoother;
     bool SmoothSimultaneously;
@@ -130,10 +291,48 @@ public:
      * @param origin Origin of data
      * @param spacing Side length of voxels
      * @param dimensions Number of voxels in each dimension
+     * @param CacheMaterialIDs If true (or if the option cachecallback is given), the callback function is evaluated once
+     * per voxel in parallel and all queries are answered from the cached voxels. The callback function must then be
+     * thread-safe.
      */
     void LoadCallback(cbMaterialIDByCoordinate MaterialIDByCoordinate, std::array<double, 3> origin,
+                      std::array<double, 3> spacing, std::array<int, 3> dimensions, bool CacheMaterialIDs = false);
+
+    /**
+     * @brief Loads data using a batch callback function which gives the material IDs of a slab of voxels at a time. The
+     * voxels are sampled once, in parallel, and all queries are answered from the cached voxels. The callback function
+     * must be thread-safe.
+     * @param MaterialIDsBySlab Pointer to function which fills a buffer with the material IDs of a slab of voxels
+     * @param origin Origin of data
+     * @param spacing Side length of voxels
+     * @param dimensions Number of voxels in each dimension
+     */
+    void LoadCallback(cbMaterialIDsBySlab MaterialIDsBySlab, std::array<double, 3> origin,
                       std::array<double, 3> spacing, std::array<int, 3> dimensions);
 
+    /**
+     * @brief Loads voxel data held in memory by the caller. The data must remain valid as long as this object is used.
+     * The first FindSurfaces copies the voxels into a remapped and padded label grid, cf. ArrayImporter::GiveLabelGrid,
+     * which takes one label of 1, 2 or 4 bytes per voxel of the padded grid.
+     * @param Data Pointer to material IDs. T is an 8, 16 or 32 bit integer type.
+     * @param dimensions Number of voxels in each dimension
+     * @param origin Origin of data
+     * @param spacing Side length of voxels
+     * @param strides Distance in memory (in elements) between neighbouring voxels in each dimension. Use
+     * {1, nx, nx*ny} for Fortran (x fastest) and {ny*nz, nz, 1} for C (z fastest) ordering. If all are zero, Fortran
+     * ordering is assumed.
+     */
+    template <typename T>
+    void LoadArray(const T *Data, std::array<int, 3> dimensions, std::array<double, 3> origin,
+                   std::array<double, 3> spacing, std::array<size_t, 3> strides = {{0, 0, 0}})
+    {
+        STATUS("Setup voxel data from array\n", 0);
+        this->Imp = new ArrayImporter<T>(Data, dimensions, origin, spacing, strides);
+        this->ApplyCutOutOption();
+        this->ApplyLabelLayoutOption();
+        FinalizeLoad();
+    }
+
     /**
      * @brief FindVolumeContainingPoint finds the volume that contains the point P
      * @param P [in] Point
@@ -141,6 +340,21 @@ public:
      */
     Volume *FindVolumeContainingPoint(std::array<double, 3> P);
 
+    /**
+     * @brief Finds the surface separating two phases
+     * @param Phase0 [in] Phase on one side of the surface
+     * @param Phase1 [in] Phase on the other side of the surface
+     * @return Pointer to surface or NULL if the phases do not share a surface
+     */
+    Surface *GiveSurface(int Phase0, int Phase1);
+
+    /**
+     * @brief Finds the phase edges along which exactly the given phases meet. Only valid after the edges are found.
+     * @param Phases [in] Phases, in any order
+     * @return List of phase edges (empty if none found)
+     */
+    std::vector<PhaseEdge *> GivePhaseEdges(std::vector<int> Phases);
+
 
     /**
      * @brief Performs smoothing process for loaded data. The process includes both smoothing and coarsening of the mesh.